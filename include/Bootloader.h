@@ -1,3 +1,5 @@
+#pragma once
+
 // Shamelessly stolen from ctrtool.
 typedef struct {
     u8 signature[0x100];
@@ -128,4 +130,37 @@ typedef struct {
     u8 hashes[8][0x20];
 } exefs_header;
 
+// One section of the ExeFS, the offset is from the start of the file
+typedef struct {
+    char name[9];
+    u64 offset;
+    u32 size;
+    u8 hash[0x20];
+} ncch_section;
+
+// The headers of a NCCH, they are parsed once and looked up by everyone that opens the content
+struct NcchContainer {
+    std::string path; // content it was read from, empty for the ones inside of FIRM
+    ctr_ncchheader header;
+    exheader_header exheader;
+    u64 exefs_offset;
+    u32 exefs_size;
+    u64 romfs_offset;
+    u64 romfs_size;
+    ncch_section sections[8]; // in ExeFS order, unused ones have size 0
+
+    const ncch_section* FindSection(const char* name) const;
+};
+
+bool ParseNcch(FILE* fd, u64 offset, NcchContainer& out);
+
+/// Size of a compressed .code once it is decompressed
+u32 GetDecompressedSize(u8* compressed, u32 compressedsize);
+/// Decompresses a .code, decompressed has to hold GetDecompressedSize bytes, returns 0 if the data is broken
+int Decompress(u8* compressed, u32 compressedsize, u8* decompressed, u32 decompressedsize);
+
+FILE* openapp(u32 titlehigh, u32 titlelow);
+/// Opens the content of a title, container is the cached parse of it or NULL if it is no NCCH
+FILE* openapp(u32 titlehigh, u32 titlelow, const NcchContainer*& container);
+
 int Boot(KKernel* kernel);
@@ -40,6 +40,13 @@ typedef uint64_t bit64;
 
 #define notcritical(x) (x)
 
+// VS2013 has no thread_local
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 #include "Log.h"
 
 #endif
@@ -1,5 +1,6 @@
 #include "Common.h"
 #include <unordered_map>
+#include <vector>
 
 typedef s32 Result;
 const Result Success = 0;
@@ -65,10 +66,11 @@ struct ThreadContext {
 #include "kernel/Thread.h"
 #include "arm/interpreter/arm_interpreter.h"
 #include "arm/dyncom/arm_dyncom.h"
+#include "arm/dyncom/arm_dyncom_jit.h"
 #include "kernel/Process.h"
 #include "arm/ArmCore.h"
-#include "kernel/Kernel.h"
 #include "kernel/Scheduler.h"
+#include "kernel/Kernel.h"
 #include "kernel/Memory.h"
 #include "kernel/AddressArbiter.h"
 #include "kernel/Swi.h"
@@ -1,8 +1,71 @@
-#define LOG(...) do {                                     \
-        printf(__VA_ARGS__);                              \
-        printf("\n");                                     \
+#pragma once
+
+/* LogLevel */
+#define LOGLEVEL_TRACE   0
+#define LOGLEVEL_DEBUG   1
+#define LOGLEVEL_INFO    2
+#define LOGLEVEL_WARNING 3
+#define LOGLEVEL_ERROR   4
+#define LOGLEVEL_NONE    5
+
+// messages below this level are not compiled in
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOGLEVEL_DEBUG
+#endif
+
+/* LogClass */
+#define LOGCLASS_GENERAL 0
+#define LOGCLASS_KERNEL  1
+#define LOGCLASS_IPC     2
+#define LOGCLASS_FS      3
+#define LOGCLASS_P9      4
+#define LOGCLASS_GPU     5
+#define LOGCLASS_DSP     6
+#define LOGCLASS_HW      7
+#define LOGCLASS_CITRA   8
+#define LOGCLASS_COUNT   9
+
+// a file can define its class before including Common.h
+#ifndef LOG_CLASS
+#define LOG_CLASS LOGCLASS_GENERAL
+#endif
+
+// minimum level that is logged per class
+extern unsigned char log_levels[LOGCLASS_COUNT];
+
+/**
+ * Queues a message in the ring buffer of the calling thread, a background thread writes it to
+ * stdout. Errors are written before this returns.
+ */
+void LogWrite(int log_class, int level, const char* format, ...);
+/// Logs size bytes as hex in one line
+void LogHex(int log_class, int level, const unsigned char* data, unsigned int size);
+/// Waits until every queued message was written
+void LogFlush();
+/// Gives the ring of the calling thread to the next thread that logs, threads that end before the emulator call this last
+void LogReleaseThread();
+/// Applies a space separated list of class:level rules, e.g. "*:warning ipc:trace"
+bool LogParseLevels(const char* rules);
+
+#define LOG_AT(level, ...) do {                           \
+        if ((level) >= log_levels[LOG_CLASS])             \
+            LogWrite(LOG_CLASS, level, __VA_ARGS__);      \
     } while(0);
-#define XDSERROR(...) do {                                   \
-        printf(__VA_ARGS__);                              \
-        printf("\n");                                     \
+
+#if LOG_MIN_LEVEL <= LOGLEVEL_TRACE
+#define LOGTRACE(...) LOG_AT(LOGLEVEL_TRACE, __VA_ARGS__)
+#else
+#define LOGTRACE(...) do { } while(0);
+#endif
+#if LOG_MIN_LEVEL <= LOGLEVEL_DEBUG
+#define LOGDEBUG(...) LOG_AT(LOGLEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOGDEBUG(...) do { } while(0);
+#endif
+#define LOG(...) LOG_AT(LOGLEVEL_INFO, __VA_ARGS__)
+#define XDSERROR(...) LOG_AT(LOGLEVEL_ERROR, __VA_ARGS__)
+
+#define LOGHEX(data, size) do {                                   \
+        if (LOGLEVEL_INFO >= log_levels[LOG_CLASS])               \
+            LogHex(LOG_CLASS, LOGLEVEL_INFO, data, size);         \
     } while(0);
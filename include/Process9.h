@@ -1,4 +1,5 @@
 #include "process9/file.h"
+#include "process9/hashcache.h"
 #include "process9/p9fs.h"
 #include "process9/pm.h"
 #include "process9/ps.h"
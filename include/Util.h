@@ -3,6 +3,7 @@
 #include "util/Mutex.h"
 #include "util/Common.h"
 #include "util/LowPath.h"
+#include "util/Sha256.h"
 
 #ifdef _WIN32
 #include <direct.h>
@@ -12,17 +12,33 @@ class KArmCore {
 public:
     KArmCore(KKernel* kernel);
 
-    u64 RunCycles(uint cycles);
+    /**
+     * Runs the thread that was set for about cycles clock cycles
+     * @param clock System clock when the slice starts
+     * @return Clock cycles the core used
+     */
+    u64 RunCycles(u64 cycles, u64 clock);
+    /// System clock as seen by the thread that runs, only valid while InSlice
+    u64 GetClock();
+    bool InSlice();
+    /// Clock cycles per instruction in 1/256 steps, 256 is one cycle per instruction
+    void SetCyclesPerInstruction(u32 cpi);
     ArmCoreState GetState();
     u32 GetRegister(uint id);
     void SetRegister(uint id,uint data);
     void SetThread(KThread* thread);
+    /// Thread that was set, NULL once it was released
+    KThread* GetThread();
+    /// Saves the context of the thread that ran last, so it can be changed while the core runs others
+    void ReleaseThread();
     void ReSchedule();
-	void Addticks(int ticks);
-	s64 Getticks();
 
 private:
     ARM_DynCom m_cpu;
     KKernel* m_kernel;
     KThread* m_thread;
+    u32 m_cpi;
+    u32 m_cycle_fraction; // 1/256 cycles that are left over from the last slice
+    u64 m_slice_start;
+    bool m_in_slice;
 };
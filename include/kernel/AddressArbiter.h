@@ -17,6 +17,6 @@ public:
 
 private:
     KProcess* m_owner;
-    KLinkedList<KThread> arbiterlist;
+    KIntrusiveList<KThread, &KThread::m_arbiter_link> arbiterlist;
     PMutex m_Mutex;
 };
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include <array>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "Hardware.h"
 
 #define SERVICECORE 1
+#define MAX_CORES 4
+// threads are switched round robin after each slice, so a slice may not run longer than this
+#define MAX_SLICE_CYCLES 1000
+// with more than one core the cores wait for each other at least this often
+#define MAX_QUANTUM_CYCLES 20000
+#define ARM11_CLOCK_RATE 268111856
 
 
 class Process9;
@@ -11,10 +20,28 @@ class KInterrupt;
 class KKernel {
 public:
     KKernel();
+    /**
+     * Sets the number of cores that run threads, call it before the first process is added.
+     * With more than one core each runs on its own host thread, see ThreadsRunTemp.
+     */
+    void SetCoreCount(s32 count);
+    u32 GetCoreCount();
+    /// When every thread waits the host sleeps till the next event is due instead of skipping ahead at once
+    void SetRealTime(bool realtime);
+    /// Clock cycles one instruction takes, below 1 overclocks the guest and above 1 underclocks it
+    void SetCyclesPerInstruction(double cpi);
+    /// The system clock in ARM11_CLOCK_RATE ticks, inside a slice it includes what the calling core ran so far
+    u64 GetSystemTick();
+    static u64 NanosecondsToTicks(s64 nanoseconds);
+    /// Thread that runs on the core of the calling host thread, NULL outside of a slice
+    KThread* GetCurrentThread();
     void AddQuickCodeProcess(u8* buf, size_t size); // TEMP
     void AddProcess(KProcess* p, bool is_firm_process);
     void StartThread(KThread* p);
     void StopThread(KThread* p);
+    /// Queues or unqueues p after it was started, stopped, blocked or woken up
+    void UpdateReadyState(KThread* p);
+    void SetThreadPriority(KThread* p, s32 prio);
     void ReScheduler();
     void ThreadsRunTemp();
     u32 GetNextThreadID();
@@ -22,12 +49,15 @@ public:
     s32 RegisterInterrupt(u32 name, KSynchronizationObject* syncObject, s32 priority, bool isManualClear);
     s32 UnRegisterInterrupt(u32 name, KSynchronizationObject* syncObject);
     void FireInterrupt(u32 name);
+	/// Fires eve ticks system ticks from now, 0 cancels it
 	void FireNextTimeEvent(KTimeedEvent* eve, u64 ticks);
+	void CancelTimeEvent(KTimeedEvent* eve);
+    void DumpDyncomStats();
     u32 m_numbFirmProcess;
     KLinkedList<KPort> m_Portlist;
     KLinkedRefList<KProcess> m_processes;
-    KMemoryMap* m_IPCFIFOAdresses[0xF];
-    bool m_IPCFIFOAdressesRO[0xF];
+    KMemoryMap* m_IPCFIFOAdresses[0x10];
+    bool m_IPCFIFOAdressesRO[0x10];
     u8 m_FIRM_Launch_Parameters[0x1000];
 
     Process9* m_p9;
@@ -45,17 +75,60 @@ public:
 	GPUHW * m_GPU;
 	HID * m_HID;
 	MIC * m_MIC;
-	KLinkedList<KTimeedEvent> m_Timedevent;
+	KTimedEventQueue m_Timedevent;
+	u64 m_cycles; // system clock at the end of the last slice, timed events are due at absolute counts
+	std::recursive_mutex m_lock; // guards the kernel objects when more than one core runs, see KKernelLock
 
 
 private:
-	u64 FindTimedEventWithSmallestCyclesRemaining();
+	/// Cycles till the next timed event is due, at most max
+	u64 NextEventCycles(u64 max);
+	void RunTimedEvents();
+	bool AllThreadsWaiting();
+	/// Moves the clock to the next event, false if no event is scheduled, the caller runs the events
+	bool SkipIdle();
+	/// Host time the clock gets to cycles in -realtime mode
+	std::chrono::steady_clock::time_point RealTimeAt(u64 cycles);
+	void RunCores();
+	void RunCore(u32 id);
+	/// Waits till every core ran the quantum, core 0 then runs the timed events and starts the next one
+	void EndQuantum(u32 id);
     KArmCore m_core0;
     KArmCore m_core1;
     KArmCore m_core2;
     KArmCore m_core3;
-    KLinkedList<KThread> tempsh;
+    KArmCore* m_cores[MAX_CORES];
+    KScheduler m_scheduler[MAX_CORES]; // ready threads of each core, each gets one slice per round
+    u32 m_num_cores;
+    u32 m_next_core; // core of the next process
+    std::mutex m_quantum_mutex;
+    std::condition_variable m_quantum_cond;
+    u32 m_quantum; // counts the quanta, the waiting cores go on once it changes
+    u32 m_cores_waiting;
+    u64 m_quantum_cycles; // length of the current quantum
+    bool m_realtime;
+    std::chrono::steady_clock::time_point m_realtime_start; // host time at m_realtime_cycles
+    u64 m_realtime_cycles;
     u32 m_NextProcessID;
     u32 m_NextThreadID;
+    u32 m_rounds;
     KLinkedList<KInterrupt> *m_Interrupt[0x80];
 };
+
+/// Holds the kernel lock while in scope, it does nothing while only one core runs
+class KKernelLock {
+public:
+    KKernelLock(KKernel* kernel) : m_kernel(kernel && kernel->GetCoreCount() > 1 ? kernel : NULL)
+    {
+        if (m_kernel)
+            m_kernel->m_lock.lock();
+    }
+    ~KKernelLock()
+    {
+        if (m_kernel)
+            m_kernel->m_lock.unlock();
+    }
+
+private:
+    KKernel* m_kernel;
+};
@@ -4,6 +4,14 @@ template<class T> struct KLinkedListNode {
     T* data;
 };
 
+// every node has the same size whatever it points to, so all lists share one pool
+#define LIST_NODE_SIZE sizeof(KLinkedListNode<void>)
+
+/// Takes a node from the pool of the calling host thread, NULL if out of memory
+void* KLinkedListAllocNode();
+/// Gives a node back, any thread may free nodes of any other
+void KLinkedListFreeNode(void* node);
+
 template<class T> class KLinkedList {
 public:
     KLinkedList() {
@@ -11,8 +19,7 @@ public:
     }
 
     int AddItem(T* item) {
-        KLinkedListNode<T>* node = (KLinkedListNode<T>*)
-            malloc(sizeof(KLinkedListNode<T>));
+        KLinkedListNode<T>* node = (KLinkedListNode<T>*)KLinkedListAllocNode();
 
         if(node == NULL)
             return 1;
@@ -40,6 +47,7 @@ public:
         if(next != NULL)
             next->prev = prev;
 
+        KLinkedListFreeNode(item);
         return 0;
     }
 
@@ -48,7 +56,7 @@ public:
 
         while(p != NULL) {
             KLinkedListNode<T>* next = p->next;
-            free(p); p = next;
+            KLinkedListFreeNode(p); p = next;
         }
     }
 
@@ -77,7 +85,54 @@ public:
             KLinkedListNode<T>* next = p->next;
 
             p->data->ReleaseReference();
-            free(p); p = next;
+            KLinkedListFreeNode(p); p = next;
         }
     }
 };
+
+/// Links of an object that is kept in a KIntrusiveList, one per list the object can be in
+template<class T> struct KIntrusiveLink {
+    KIntrusiveLink() : next(NULL), prev(NULL) {}
+    T* next;
+    T* prev;
+};
+
+// Keeps the links in the items, so adding and removing an item never allocates and removal needs no search.
+template<class T, KIntrusiveLink<T> T::*Link> class KIntrusiveList {
+public:
+    KIntrusiveList() {
+        list = NULL;
+    }
+
+    void AddItem(T* item) {
+        KIntrusiveLink<T>& link = item->*Link;
+        link.prev = NULL;
+        link.next = list;
+
+        if(list != NULL)
+            (list->*Link).prev = item;
+
+        list = item;
+    }
+
+    void RemoveItem(T* item) {
+        KIntrusiveLink<T>& link = item->*Link;
+
+        if(link.prev != NULL)
+            (link.prev->*Link).next = link.next;
+        else
+            list = link.next;
+
+        if(link.next != NULL)
+            (link.next->*Link).prev = link.prev;
+
+        link.prev = NULL;
+        link.next = NULL;
+    }
+
+    static T* Next(T* item) {
+        return (item->*Link).next;
+    }
+
+    T* list;
+};
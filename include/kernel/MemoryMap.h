@@ -95,6 +95,22 @@ typedef u16 MemoryState;
 /* PageFlags */
 typedef u8 PageFlags;
 
+#define PAGE_FLAG_CODE 1 // blocks were translated from this page, changing it drops them
+
+/* WatchAccess */
+#define WATCH_READ  1
+#define WATCH_WRITE 2
+#define WATCH_RW    3
+
+#define MAX_WATCHES 16
+
+struct MemoryWatch {
+    u32 start;
+    u32 end; // last watched byte
+    u8 access;
+    char process[9]; // empty for every process
+};
+
 struct MemoryInfo {
     u32 base_address;
     u32 size;
@@ -109,7 +125,8 @@ struct PageInfo {
 struct MemChunk {
     u32 size;
     u8* data;
-    u32 ref_count;
+    u32 ref_count; // pages that map the chunk in any process
+    bool owned;    // data was allocated for the chunk and is freed with it
 };
 
 struct MemPage {
@@ -129,22 +146,50 @@ class KMemoryBlock;
 #define PAGE_SIZE                                                        0x1000
 #define PAGE_MASK                                                         0xFFF
 #define HEAP_VA_START                                                0x08000000
+#define NUM_FAST_PAGES                                                 0x100000
+#define NUM_LEAF_PAGES                                                    0x100
+#define IPC_VA_START                                                 0x04000000
+#define IPC_VA_END                                                   0x08000000
 
 class KMemoryMap {
 public:
     KMemoryMap(KProcess* process);
+    ~KMemoryMap();
+
+    /// Host address of the page holding addr when it is plain memory that may be read, else NULL
+    u8* GetReadPage(u32 addr) {
+        return m_fast_read[addr / PAGE_SIZE];
+    }
+    /// Host address of the page holding addr when it is plain memory that may be written, else NULL
+    u8* GetWritePage(u32 addr) {
+        return m_fast_write[addr / PAGE_SIZE];
+    }
 
     Result Read8 (u32 addr, u8&  out);
     Result Read16(u32 addr, u16& out);
     Result Read32(u32 addr, u32& out);
     Result Read64(u32 addr, u64& out);
-	Result ReadN(u32 addr, u8* out, u32 size);
     Result Write8 (u32 addr, u8  val);
     Result Write16(u32 addr, u16 val);
     Result Write32(u32 addr, u32 val);
     Result Write64(u32 addr, u64 val);
 
+    // Bulk accesses, plain memory is copied a page at a time, IO and faulting pages go through
+    // Read8/Write8. They stop at the first byte that fails.
+    Result ReadN(u32 addr, u8* out, u32 size);
+    Result WriteN(u32 addr, const u8* in, u32 size);
+    Result Fill(u32 addr, u8 val, u32 size);
+    Result CopyFrom(KMemoryMap& src, u32 src_addr, u32 dst_addr, u32 size);
+
     Result IPCMap(u32 addr0, u32 addr1, u32 size, MemoryPermissions perm, KMemoryMap * mapto);
+    /**
+     * Maps the pages holding [src_addr, src_addr + size) of src into the IPC window of this map. Both
+     * maps share the chunks of the pages, so nothing is copied.
+     * @param addr_out Address of src_addr in this map
+     */
+    Result MapIPCBuffer(KMemoryMap& src, u32 src_addr, u32 size, MemoryPermissions perm, u32* addr_out);
+    /// Unmaps a buffer that MapIPCBuffer returned, src is the map it came from
+    Result UnmapIPCBuffer(KMemoryMap& src, u32 addr, u32 size);
 
     Result ControlMemory(u32* addr_out, u32 addr0, u32 addr1, u32 size,
         MemoryOperation op, MemoryPermissions perm);
@@ -166,6 +211,19 @@ public:
     Result RemovePages(u32 addr, u32 size);
 	s32 AllocFreeGSP(bool new3DS, u32 size);
 	Result MapIOData(u32 address, u32 size,u8*data, MemoryPermissions perm);
+    void WatchCode(u32 addr);
+
+    /**
+     * Logs accesses to [start, end]. The pages of the range are taken out of the fast tables of every
+     * process, so nothing else gets slower.
+     * @param access WATCH_READ, WATCH_WRITE or both
+     * @param process Name of the process to log, NULL for all of them
+     */
+    static Result AddWatch(u32 start, u32 end, u8 access, const char* process);
+    /// Adds a watch given as start-end[:r|w|rw][@process], the addresses are hex
+    static Result AddWatch(const char* spec);
+    static void ClearWatches();
+
     KProcess* m_process;
 #ifndef XDS_TEST
 private:
@@ -174,16 +232,40 @@ private:
     Result VerifyRegionMaskState(u32 addr, u32 size, MemoryState state);
     Result Reprotect(u32 addr, u32 size, MemoryPermissions perm);
     Result CreateChunk(MemChunk** chunk_out, u32 size);
+    /// Drops the reference of one page, owned chunks are freed with their last page
+    static void ReleaseChunk(MemChunk* chunk);
 
     Result AddMirror(u32 mirror, u32 mirrored, u32 size,
         MemoryPermissions perm);
     Result AddMirror(u32 mirror, u32 mirrored, u32 size,
         MemoryPermissions perm, KMemoryMap * mapto);
     Result RemoveMirror(u32 mirror, u32 mirrored, u32 size);
+    void InvalidateCode(u32 page);
+    void UpdateFastPage(u32 page);
+    static void UpdateWatchedPages(u32 start, u32 end);
+    static bool IsWatchedPage(u32 page);
+    void LogAccess(u32 addr, u32 val, u32 size, u8 access);
 
-    MemPage m_pages[NUM_PAGES];
+    /// Descriptor of a page, all pages without a leaf share one free descriptor
+    const MemPage& GetPage(u32 page) const {
+        MemPage* leaf = page < NUM_PAGES ? m_leaves[page / NUM_LEAF_PAGES] : NULL;
+        return leaf ? leaf[page % NUM_LEAF_PAGES] : s_free_page;
+    }
+    /// Descriptor of a page that is about to change, its leaf is allocated on first use
+    MemPage& AllocPage(u32 page);
+
+    // the leaves are only allocated for parts of the address space that get mapped
+    MemPage* m_leaves[NUM_PAGES / NUM_LEAF_PAGES];
+    static const MemPage s_free_page;
+    // cover all 4GB so lookups need no bounds check, only the parts that get used are touched
+    u8** m_fast_read;
+    u8** m_fast_write;
+
+    static MemoryWatch s_watches[MAX_WATCHES];
+    static u32 s_num_watches;
+    // every map, so watches that are added later reach the processes that already run
+    static std::vector<KMemoryMap*> s_maps;
     bool m_TLSused[0x100]; //the maximum number of TLS that are possible because of the ResourceLimit
     u8* m_TLSpointer[0x100/8];
+    u32 m_ipc_next; // page the search for free space in the IPC window goes on at
 };
-
-// TODO: Free chunks when ref_count == 0.
@@ -1,6 +1,9 @@
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 class KKernel;
-#define bb_map std::unordered_map<u32, int>
 
 class KProcess : public KSynchronizationObject
 {
@@ -16,6 +19,8 @@ public:
     KMemoryMap* getMemoryMap();
 
     void AddQuickCode(u8* buf, size_t size);
+    void InvalidateCode(u32 addr); //drops the translated blocks of the page containing addr, other cores queue it
+    void RunPendingInvalidations(); //called by m_host_core between slices
 
     void AddThread(KThread * thread);
 
@@ -37,18 +42,22 @@ public:
     static const ClassName name = KProcess_Class;
     KKernel* m_Kernel;
     u32  m_ProcessID;
+    u32  m_host_core; // all threads run on this core, the creams and the jit are not shared between cores
 
 	//Dyncore stuff
-	char* repretBuffer;
-	int repretBuffersize;
-	int repretBuffertop;
+	CreamArena* CreamBuffer;
 	bb_map *CreamCache;
+	ARM_Jit* m_jit; //NULL when the interpreter runs everything
 
 private:
     u32 static Read32(uint8_t p[4]);
     void ParseArm11KernelCaps(u32 capabilities_num, u32* capabilities_ptr);
-    KLinkedList<KThread> m_Threads;
+    KIntrusiveList<KThread, &KThread::m_process_link> m_Threads;
     KAutoObjectRef m_limit;
+    // pages other cores and host threads changed, the creams and the jit are only touched by m_host_core
+    std::mutex m_invalidate_mutex;
+    std::vector<u32> m_invalidate_pages;
+    std::atomic<bool> m_invalidate_pending;
     KAutoObjectRef m_codeset;
     KHandleTable* m_handles;
     bool m_AllowedInterrupt[0x7E];
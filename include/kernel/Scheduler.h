@@ -37,6 +37,13 @@ public:
     KThread* ScheduleThreads(int z);
     void Reschedule(KThread* schedule_thread, bit8 lower_scheduling_mask);
 
+    /// First queued thread whose priority is from or lower
+    KThread* FirstThread(s32 from);
+    /// Makes every queued thread due once more, in priority order
+    void StartRound();
+    /// Next thread of the round, NULL once all threads that are still queued had their turn
+    KThread* NextInRound();
+
     void SwitchKernelContext(int z);
     void SwitchThreadContext(SwitchContext* c);     // switchA
     void ReturnThreadContext(SwitchContext* c);     // switchB
@@ -44,10 +51,12 @@ public:
 
     inline s32 GetPrioType(s32 prio)    { return (prio & PRIO_TYPE_MASK) >> 5; }
     inline s32 GetPrioField(s32 prio)   { return prio & PRIO_FIELD_MASK; }
+    inline s32 GetQueuePrio(s32 prio)   { return prio < PRIO_HIGH ? PRIO_HIGH : (prio > PRIO_LOW ? PRIO_LOW : prio); }
 
     void OtherCoreTriggerIntr8();
 
 private:
+    KThread* Successor(KThread* thread);
 
     u32 m_scheduler_count;              //used in the 3 context switch functions
     bool m_switch_context;
@@ -62,6 +71,7 @@ private:
     u32 m_unknown2;
     u32 m_unknown3;
     ThreadScheduleList m_schedule_entries[64];  // 1 per prio, 0-3F
+    KThread* m_round_next;              // thread that runs next in the current round
 
 };
 
@@ -1,4 +1,14 @@
 
+// words in the command buffer of a thread, header included
+#define IPC_MAX_WORDS 0x40
+
+/// A buffer a request mapped into the server
+struct KIPCBuffer {
+    u32 addr;     // where the server sees it
+    u32 size;
+    u32 src_addr; // where the client has it
+};
+
 class KSession : public KAutoObject
 {
 public:
@@ -17,9 +27,17 @@ public:
     KServerSession m_Server;
     KClientSession m_Client;
     KPort * m_owner; //this is for debugging
-    KLinkedList<u32> m_openMemAddr;
-    KLinkedList<u32> m_openMemSize;
+    u64 m_messages; // requests and replies that went through Communicate
+    u64 m_bytes;    // plain words and static buffers they copied
+    s32 m_p9_channel; // PXI channel the server passes the requests on to unchanged, -1 till it did so once
 private:
+    void UnmapBuffers();
+
+    // buffers of the request the server works on, they are unmapped when it replies
+    KIPCBuffer m_buffers[IPC_MAX_WORDS / 2];
+    u32 m_num_buffers;
+    KMemoryMap* m_buffer_map;
+    KMemoryMap* m_buffer_src; // the client, it waits for the reply so it is still there
 };
 
 
@@ -1,5 +1,16 @@
 
 class KThread;
+class KSynchronizationObject;
+
+/// One object a thread waits for, it is linked into the wait queue of the object while the thread waits
+struct KWaitBlock {
+    KThread* thread;
+    KSynchronizationObject* object;
+    KWaitBlock* next;
+    KWaitBlock* prev;
+    s32 index; // position of the object in the wait call, the thread gets it back in r1
+    bool queued;
+};
 
 class KSynchronizationObject : public KAutoObject
 {
@@ -11,17 +22,22 @@ public:
     virtual bool Synchronization(KThread* thread,u32 &error) = 0;
 
     virtual bool IsInstanceOf(ClassName name);
-    bool Syn(KThread* thread, u32 &error);
-    void SynRemove(KThread* thread);
+    /// Queues block and calls Synchronization, true if the thread has to wait
+    bool Syn(KWaitBlock* block, u32 &error);
+    void SynRemove(KWaitBlock* block);
 
     static const ClassName name = KAutoObject_Class;
+    /// Wakes thread, which has to wait for this object
     void SynFree(u32 errorCode, KThread* thread);
+    /// Waiting thread with the best priority, threads of the same priority come in the order they started to wait
     KThread* SynGetNextPrio();
     void SynFreeAll(u32 errorCode);
 
 	bool m_killed;
 
 private:
-    KLinkedList<KThread> waiting;
+    // queue ordered by the priority the threads had when they started to wait
+    KWaitBlock* m_wait_first;
+    KWaitBlock* m_wait_last;
 
 };
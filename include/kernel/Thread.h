@@ -1,6 +1,10 @@
 #pragma once
 
 class KArmCore;
+class KSession;
+
+// WaitSynchronizationN takes at most this many handles
+#define MAX_WAIT_OBJECTS 256
 
 enum SchedulingTask : bit8 {
 
@@ -20,12 +24,20 @@ public:
     ~KThread();
 
     bool Synchronization(KThread* thread, u32 &error);
-    void SyncFree(s32 errorCode, KSynchronizationObject* obj);
-    void SyncStall(KLinkedList<KSynchronizationObject>* objects, bool waitAll);
+    /// Called by an object that took block out of its wait queue
+    void SyncFree(s32 errorCode, KWaitBlock* block);
+    /**
+     * Waits for count objects, with waitAll till every one was free, else till the first one is.
+     * r0 gets the error code and r1 the index of the object that ended the wait, unless all were waited for.
+     */
+    void SyncStall(KSynchronizationObject** objects, u32 count, bool waitAll);
+    void SetWaitResult(s32 errorCode, s32 index, bool has_index);
 	void stop();
 	void trigger_event();
     bool m_waitAll;
-    KLinkedList<KSynchronizationObject> *Threadwaitlist; //if there is nothing inside the thread is freed
+    u32 m_wait_left; // objects that still have to be free, the thread waits while this is not 0
+    u32 m_wait_count;
+    KWaitBlock m_wait_blocks[MAX_WAIT_OBJECTS];
 
     virtual bool IsInstanceOf(ClassName name);
     virtual void Destroy();
@@ -40,14 +52,21 @@ public:
     KArmCore* m_core;
     u32 m_thread_id;
 
+    // links in the ready queue of the kernel
     KThread* m_prev;
     KThread* m_next;
+    s32 m_queued_prio;
+    bool m_started; // started and not held by an address arbiter
+    bool m_ready;   // queued, so it gets slices
 
     u32 m_TSL3DS;
     u8* m_TSLpointer;
     KProcess* m_owner;
+    KSession* m_ipc_session; // session of the request the thread works on till it replies
 
     u32 arb_addr;
+    KIntrusiveLink<KThread> m_arbiter_link; // in the list of the arbiter it waits for
+    KIntrusiveLink<KThread> m_process_link; // in the thread list of m_owner
 
     ThreadContext m_context;
 
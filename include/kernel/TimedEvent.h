@@ -5,13 +5,32 @@
 class KTimeedEvent
 {
 public:
-	KTimeedEvent(){ num_cycles_remaining = 0; }
+	KTimeedEvent(){ m_deadline = 0; m_queue_index = -1; }
 	~KTimeedEvent(){ }
-	s64 num_cycles_remaining;
+	u64 m_deadline; // kernel cycle count the event fires at
+	s32 m_queue_index; // position in the event queue, -1 when not scheduled
 	virtual void trigger_event() = 0;
 
 
 private:
 };
 
+/// Scheduled events in a binary heap ordered by deadline
+class KTimedEventQueue
+{
+public:
+	/// Schedules eve at deadline, an event that is already queued is moved
+	void Schedule(KTimeedEvent* eve, u64 deadline);
+	void Cancel(KTimeedEvent* eve);
+	/// Deadline of the next event or ~0 if nothing is scheduled
+	u64 NextDeadline() const;
+	/// Removes and returns the next event if it is due at now, else NULL
+	KTimeedEvent* PopDue(u64 now);
 
+private:
+	void SiftUp(u32 i);
+	void SiftDown(u32 i);
+	void Place(u32 i, KTimeedEvent* eve);
+
+	std::vector<KTimeedEvent*> m_heap;
+};
@@ -10,7 +10,21 @@ public:
     void FIFOIRQOLD(); //this is unused on the 3DS
     void Sendresponds(u32 myid,u32 data[]);
     u64 GetTitleFromPM(u64 handle);
+    /**
+     * With HLE on, requests that pxi passed on to the FIFO unchanged once are handed to the
+     * handlers right away when they come again, the register path stays for accuracy testing
+     */
+    void SetHLE(bool hle);
+    bool IsHLE();
+    /**
+     * Runs the request in the command buffer of client on channel and writes the reply back
+     * @return false when the request has descriptors that only pxi can translate
+     */
+    bool HLERequest(u32 channel, KThread* client);
 private:
+    void Dispatch(u32 data[]);
+    void LearnChannel();
+
 	P9MC m_MC;
 	P9FS m_FS;
     P9PM m_PM;
@@ -21,6 +35,8 @@ private:
     u32 m_datarecv[0x200]; //this is more than enough
     u32 m_datasend[0x200]; //this is more than enough
     bool m_IntiHadData;
+    bool m_hle;
+    u32* m_hle_reply; // command buffer of the client while an HLE request runs
 };
 
 
@@ -10,7 +10,12 @@ public:
 	virtual s32 setsize(u64 size);
 	virtual s32 read(u8 *buffer, u32 size, u64 file_offset, u32 &out_sizeread);
 	virtual s32 write(u8 *buffer, u32 size, u64 file_offset, u32 &out_sizewritten);
+	/// SHA-256 of the whole file, hash that was given to the constructor or computed when it is first asked for
 	virtual u8* GetHashPtr();
+	/// The file is [offset, offset + size) of path and never changes, it is hashed in the background
+	void SetContentPath(const char* path);
+	/// Reads from a mapping of the file from now on, only for containers nobody writes to
+	bool MapRead();
 
 	enum {
 		OPEN_READ = 1,
@@ -65,6 +70,8 @@ private:
 	FILE* m_fs;
 	u8 *m_hash;
 	u32 m_achivetype;
+	bool m_mapped;
+	Common::FileView m_view;
 };
 
 
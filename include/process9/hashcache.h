@@ -0,0 +1,11 @@
+
+// SHA-256 of read only content like RomFS, the hashes are kept in NAND/sha256.cache between runs
+// and belong to a (path, size, mtime) of the file, so a content that got replaced is hashed again
+class P9HashCache
+{
+public:
+    /// Hashes [offset, offset + size) of path on the worker thread unless the hash is known
+    static void Prefetch(const char* path, u64 offset, u64 size);
+    /// Hash of [offset, offset + size) of path, it waits for the worker or hashes right away
+    static bool Get(const char* path, u64 offset, u64 size, u8* hash_out);
+};
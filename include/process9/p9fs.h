@@ -1,19 +1,5 @@
 
 class Archive;
-struct fsArchiveentry
-{
-    Archive * Archobj;
-    u64 id;
-};
-
-struct fsFileentry
-{
-	P9File * Archobj;
-	u64 id;
-};
-
-typedef fsArchiveentry s_fsArchiveEntry;
-typedef fsFileentry s_fsFileentry;
 
 class P9FS
 {
@@ -22,10 +8,14 @@ public:
     ~P9FS();
     void Command(u32 data[],u32 numb);
 private:
+    Archive* FindArchive(u64 handle);
+    P9File* FindFile(u64 handle);
+
     Process9* m_owner;
     u64 lastID = 0x110000001;
-    KLinkedList<s_fsArchiveEntry> m_open;
-	KLinkedList<s_fsFileentry> m_fopen;
+    // handles are looked up on every request and never reused
+    std::unordered_map<u64, Archive*> m_archives;
+    std::unordered_map<u64, P9File*> m_files;
 };
 
 
@@ -1,13 +1,33 @@
 // This file shouldn't exist. It has STL.
+#pragma once
 #include <string>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
 
 
 namespace Common {
+	/// A read only view of part of a file
+	struct FileView {
+		const uint8_t* data; // first byte that was asked for
+		void* base;     // the mapping starts at the page the data is in
+		uint64_t length;
+		void* handle;   // file mapping object on Windows
+	};
+
     std::string StringFromFormat(const char* format, ...);
     // Cheap!
     bool CharArrayFromFormatV(char* out, int outsize, const char* format, va_list args);
     unsigned int CountLeadingZeros(unsigned int num);
 	FILE* fopen_mkdir(const char* name, const char* mode);
+	/// Adds the names of the entries in the directory path to names_out, false if it can't be read
+	bool ListDirectory(const char* path, std::vector<std::string>& names_out);
 	char * U16ToASCII(char* data);
+	/// Maps [offset, offset + size) of fd for reading, fails if the file is shorter than that
+	bool MapFileView(FILE* fd, uint64_t offset, uint64_t size, FileView* view_out);
+	void UnmapFileView(FileView* view);
+	/// Reads or writes at offset without going through the buffer and position of fd, -1 on errors
+	int64_t ReadFileAt(FILE* fd, void* buffer, uint32_t size, uint64_t offset);
+	int64_t WriteFileAt(FILE* fd, const void* buffer, uint32_t size, uint64_t offset);
 }
 
@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Common {
+	/// Runs count 64 byte blocks through the SHA-256 compression, with the SHA extensions if the CPU has them
+	void Sha256Transform(uint32_t state[8], const uint8_t* blocks, size_t count);
+
+	class Sha256 {
+	public:
+		Sha256();
+		void Update(const void* data, size_t size);
+		void Final(uint8_t hash_out[0x20]);
+	private:
+		uint32_t m_state[8];
+		uint8_t m_block[64];
+		uint32_t m_used;   // bytes waiting in m_block
+		uint64_t m_total;
+	};
+}
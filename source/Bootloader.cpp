@@ -1,10 +1,14 @@
 #include "Kernel.h"
 
+#include <ctype.h>
 #include <stdio.h>
+#include <sys/stat.h>
+#include <thread>
 
 #include "Bootloader.h"
 
 //they are in mem in that order fs loader pm sm pix
+#define FIRM_MODULES 5
 
 
 
@@ -34,7 +38,7 @@ static u32 AlignPage(u32 in)
 {
     return ((in + 0xFFF) / 0x1000) * 0x1000;
 }
-static u32 GetDecompressedSize(u8* compressed, u32 compressedsize)
+u32 GetDecompressedSize(u8* compressed, u32 compressedsize)
 {
     u8* footer = compressed + compressedsize - 8;
 
@@ -42,12 +46,13 @@ static u32 GetDecompressedSize(u8* compressed, u32 compressedsize)
     return originalbottom + compressedsize;
 }
 
-static int Decompress(u8* compressed, u32 compressedsize, u8* decompressed, u32 decompressedsize)
+// The code is compressed backwards, a control byte is followed by 8 literals or back-references
+int Decompress(u8* compressed, u32 compressedsize, u8* decompressed, u32 decompressedsize)
 {
 
     u8* footer = compressed + compressedsize - 8;
     u32 buffertopandbottom = Read32(footer + 0);
-    u32 i, j;
+    u32 i;
     u32 out = decompressedsize;
     u32 index = compressedsize - ((buffertopandbottom >> 24) & 0xFF);
     u32 segmentoffset;
@@ -55,12 +60,20 @@ static int Decompress(u8* compressed, u32 compressedsize, u8* decompressed, u32
     u8 control;
     u32 stopindex = compressedsize - (buffertopandbottom & 0xFFFFFF);
 
-    memset(decompressed, 0, decompressedsize);
     memcpy(decompressed, compressed, compressedsize);
+    memset(decompressed + compressedsize, 0, decompressedsize - compressedsize);
 
     while (index > stopindex) {
         control = compressed[--index];
 
+        // eight literals in a row are one copy
+        if (control == 0 && index >= stopindex + 8 && out >= 8) {
+            index -= 8;
+            out -= 8;
+            memcpy(decompressed + out, compressed + index, 8);
+            continue;
+        }
+
         for (i = 0; i<8; i++) {
             if (index <= stopindex)
                 break;
@@ -82,21 +95,22 @@ static int Decompress(u8* compressed, u32 compressedsize, u8* decompressed, u32
                 segmentoffset &= 0x0FFF;
                 segmentoffset += 2;
 
-                if (out < segmentsize) {
+                // the first byte read is the highest one
+                if (out < segmentsize || out + segmentoffset >= decompressedsize) {
                     fprintf(stderr, "Error, compression out of bounds");
                     goto clean;
                 }
 
-                for (j = 0; j<segmentsize; j++) {
-                    u8 data;
-
-                    if (out + segmentoffset >= decompressedsize) {
-                        fprintf(stderr, "Error, compression out of bounds");
-                        goto clean;
-                    }
-
-                    data = decompressed[out + segmentoffset];
-                    decompressed[--out] = data;
+                out -= segmentsize;
+                u8* dst = decompressed + out;
+                u8* src = dst + segmentoffset + 1;
+                if (segmentoffset + 1 >= segmentsize) {
+                    memcpy(dst, src, segmentsize);
+                }
+                else {
+                    // the source overlaps what is written, it has to go from the top byte by byte
+                    for (u32 j = segmentsize; j-- > 0;)
+                        dst[j] = src[j];
                 }
             }
             else {
@@ -115,403 +129,486 @@ clean:
     return 0;
 }
 
-KProcess* Boot_LoadFileFast(FILE* fd, u32 offset, u32* out_offset, KKernel * Kernel)
+bool ParseNcch(FILE* fd, u64 offset, NcchContainer& out)
 {
-
-    if (fseek(fd, offset, SEEK_SET) != 0)
+    if (fseek64(fd, offset, SEEK_SET) != 0)
     {
         XDSERROR("failed to seek.");
-        return NULL;
+        return false;
     }
 
-    exheader_header ex;
-    ctr_ncchheader loader_h;
-    u32 ncch_off = 0;
-
     // Read header.
-    if (fread(&loader_h, sizeof(loader_h), 1, fd) != 1) {
+    if (fread(&out.header, sizeof(out.header), 1, fd) != 1) {
         XDSERROR("failed to read header.");
-        return NULL;
+        return false;
     }
 
     // Load NCCH
-    if (memcmp(&loader_h.magic, "NCCH", 4) != 0) {
+    if (memcmp(&out.header.magic, "NCCH", 4) != 0) {
         XDSERROR("invalid magic.. wrong file?");
-        return NULL;
+        return false;
     }
 
-    // Read Exheader.
-    if (fread(&ex, sizeof(ex), 1, fd) != 1) {
+    // Read Exheader, data only containers have none.
+    memset(&out.exheader, 0, sizeof(out.exheader));
+    if (Read32(out.header.extendedheadersize) != 0 && fread(&out.exheader, sizeof(out.exheader), 1, fd) != 1) {
         XDSERROR("failed to read exheader.");
-        return NULL;
+        return false;
     }
 
-    bool is_compressed = ex.codesetinfo.flags.flag & 1;
-    char namereal[9];
-    strncpy(namereal, (char*)ex.codesetinfo.name, 9);
+    out.exefs_offset = offset + (u64)Read32(out.header.exefsoffset) * 0x200;
+    out.exefs_size = Read32(out.header.exefssize) * 0x200;
+    out.romfs_offset = offset + (u64)Read32(out.header.romfsoffset) * 0x200;
+    out.romfs_size = (u64)Read32(out.header.romfssize) * 0x200;
 
     // Read ExeFS.
-    u32 exefs_off = Read32(loader_h.exefsoffset) * 0x200;
-    u32 exefs_sz = Read32(loader_h.exefssize) * 0x200;
+    memset(out.sections, 0, sizeof(out.sections));
+    if (out.exefs_size == 0)
+        return true;
 
-    if (fseek(fd, exefs_off + ncch_off + offset, SEEK_SET) != 0)
+    if (fseek64(fd, out.exefs_offset, SEEK_SET) != 0)
     {
         XDSERROR("failed to seek.");
-        return NULL;
+        return false;
     }
 
     exefs_header eh;
     if (fread(&eh, sizeof(eh), 1, fd) != 1) {
         XDSERROR("failed to read ExeFS header.");
-        return NULL;
+        return false;
     }
 
     for (u32 i = 0; i < 8; i++) {
-        u32 sec_size = Read32(eh.section[i].size);
-        u32 sec_off = Read32(eh.section[i].offset);
-
-        if (sec_size == 0)
+        ncch_section& sec = out.sections[i];
+        sec.size = Read32(eh.section[i].size);
+        if (sec.size == 0)
             continue;
+        memcpy(sec.name, eh.section[i].name, 8);
+        sec.name[8] = '\0';
+        sec.offset = out.exefs_offset + sizeof(eh) + Read32(eh.section[i].offset);
+        memcpy(sec.hash, eh.hashes[7 - i], 0x20); // the hashes are stored the other way round
+    }
+    return true;
+}
 
-        eh.section[i].name[7] = '\0';
+const ncch_section* NcchContainer::FindSection(const char* name) const
+{
+    for (u32 i = 0; i < 8; i++) {
+        if (sections[i].size != 0 && strcmp(sections[i].name, name) == 0)
+            return &sections[i];
+    }
+    return NULL;
+}
 
-        if (strcmp((char*)eh.section[i].name, ".code") == 0) {
-            sec_off += exefs_off + sizeof(eh);
-            if (fseek(fd, sec_off + ncch_off + offset, SEEK_SET) != 0)
-            {
-                XDSERROR("failed to seek.");
-                return NULL;
-            }
+// A module inside of FIRM, they are found one after the other and then loaded at the same time
+struct FirmModule {
+    NcchContainer ncch;
+    u64 code_offset;
+    u32 code_size;
+    bool compressed;
+    u8* text;
+    u8* rodata;
+    u8* data;
+    bool loaded;
+};
+
+static bool FindModule(FILE* fd, u32 offset, FirmModule& m, u32* out_offset)
+{
+    // the modules inside of FIRM are loaded once, they are not worth caching
+    if (!ParseNcch(fd, offset, m.ncch))
+        return false;
+
+    const ncch_section* section = m.ncch.FindSection(".code");
+    if (section == NULL) {
+        XDSERROR("finding .code section");
+        return false;
+    }
+    m.code_offset = section->offset;
+    m.code_size = section->size;
+    // Decompress first section if flag set.
+    m.compressed = section == &m.ncch.sections[0] && (m.ncch.exheader.codesetinfo.flags.flag & 1);
+    m.text = m.rodata = m.data = NULL;
+    m.loaded = false;
+
+    // the next module follows the code
+    *out_offset = (u32)(section->offset + section->size);
+    return true;
+}
 
-            u8* sec = (u8*)malloc(AlignPage(sec_size));
-            if (sec == NULL) {
-                XDSERROR("section malloc failed.");
-                return NULL;
-            }
+static u8* CopySegment(u8* src, u32 realsize)
+{
+    u32 size = AlignPage(realsize);
+    u8* segment = (u8*)malloc(size);
+    if (segment == NULL)
+        return NULL;
+    memcpy(segment, src, realsize);
+    memset(segment + realsize, 0, size - realsize);
+    return segment;
+}
 
-            if (fread(sec, sec_size, 1, fd) != 1) {
-                XDSERROR("section fread failed.");
-                free(sec);
-                return NULL;
-            }
+// reads, decompresses and splits the code, it runs on a thread of its own and does not touch the kernel
+static void LoadModule(FILE* fd, FirmModule* m)
+{
+    exheader_header& ex = m->ncch.exheader;
+    u32 sec_size = m->code_size;
+    u8* sec = (u8*)malloc(AlignPage(sec_size));
+    if (sec == NULL) {
+        XDSERROR("section malloc failed.");
+        return;
+    }
 
+    if (Common::ReadFileAt(fd, sec, sec_size, m->code_offset) != sec_size) {
+        XDSERROR("section read failed.");
+        free(sec);
+        return;
+    }
 
-            // Decompress first section if flag set.
-            if (i == 0 && is_compressed) {
-                u32 dec_size = GetDecompressedSize(sec, sec_size);
-                u8* dec = (u8*)malloc(AlignPage(dec_size));
+    if (m->compressed) {
+        u32 dec_size = GetDecompressedSize(sec, sec_size);
+        u8* dec = (u8*)malloc(AlignPage(dec_size));
 
-                if (!dec) {
-                    XDSERROR("decompressed data block allocation failed.");
-                    free(sec);
-                    return NULL;
-                }
+        if (!dec) {
+            XDSERROR("decompressed data block allocation failed.");
+            free(sec);
+            return;
+        }
 
-                u32 firmexpected = Read32(ex.codesetinfo.text.codesize) + Read32(ex.codesetinfo.ro.codesize) + Read32(ex.codesetinfo.data.codesize);
+        if (Decompress(sec, sec_size, dec, dec_size) == 0) {
+            XDSERROR("section decompression failed.");
+            free(sec);
+            free(dec);
+            return;
+        }
 
-                if (Decompress(sec, sec_size, dec, dec_size) == 0) {
-                    XDSERROR("section decompression failed.");
-                    free(sec);
-                    free(dec);
-                    return NULL;
-                }
+        free(sec);
+        sec = dec;
+        sec_size = dec_size;
+    }
 
-                /*FILE * pFile;
-                pFile = fopen("code.code", "wb");
-                if (pFile != NULL)
-                {
-                    fwrite(dec, 1, dec_size, pFile);
-                    fclose(pFile);
-                }*/
-
-                free(sec);
-                sec = dec;
-                sec_size = dec_size;
-            }
+    u32 realcodesize = Read32(ex.codesetinfo.text.codesize);
+    u32 realrodatasize = Read32(ex.codesetinfo.ro.codesize);
+    u32 realdatasize = Read32(ex.codesetinfo.data.codesize);
+    if ((u64)realcodesize + realrodatasize + realdatasize > sec_size) {
+        XDSERROR("code segments do not fit in .code");
+        free(sec);
+        return;
+    }
 
-            // Load .code section.
-            u32 realcodesize = Read32(ex.codesetinfo.text.codesize);
-            u32 codesize = AlignPage(realcodesize);
-            u8* code = (u8*)malloc(codesize);
-            if (!code) {
-                XDSERROR("text data block allocation failed.");
-                free(sec);
-                return NULL;
-            }
-            memset(code,0, codesize);
-            memcpy(code, sec, realcodesize);
-
-            u32 realrodatasize = Read32(ex.codesetinfo.ro.codesize);
-            u32 rodatasize = AlignPage(realrodatasize);
-            u8* rodata = (u8*)malloc(rodatasize);
-            if (!rodata) {
-                XDSERROR("rodata data block allocation failed.");
-                free(code);
-                free(sec);
-                return NULL;
-            }
-            memset(rodata, 0, rodatasize);
-            memcpy(rodata, sec + realcodesize, realrodatasize);
-
-            u32 realdatasize = Read32(ex.codesetinfo.data.codesize);
-            u32 datasize = AlignPage(realdatasize);
-            u8* data = (u8*)malloc(datasize);
-            if (!data) {
-                XDSERROR("data data block allocation failed.");
-                free(code);
-                free(sec);
-                free(rodata);
-                return NULL;
-            }
-            memset(data, 0, datasize);
-            memcpy(data, sec + realcodesize + realrodatasize, realdatasize);
-
-            KCodeSet* Codeset = new KCodeSet(
-                code, codesize / 0x1000,
-                rodata, rodatasize/0x1000,
-                data, datasize / 0x1000,
-                AlignPage(Read32(ex.codesetinfo.bsssize)) / 0x1000,
-                Read64(loader_h.programid),
-                namereal
-                );
-
-            KProcess* process = new KProcess(Codeset, 28, (u32*)ex.arm11kernelcaps.descriptors, Kernel,true);
-
-            //Start the process
-
-            //map stack
-            u32 unused;
-            u32 stacksize = Read32(ex.codesetinfo.stacksize);
-            process->getMemoryMap()->ControlMemory(&unused, 0x10000000 - stacksize, 0, stacksize, OPERATION_COMMIT, PERMISSION_RW);
-
-            KThread * thread = new KThread(SERVICECORE,process);
-            u32 startaddr = (process->m_exheader_flags & (1 << 12)) ? 0x14000000 : 0x00100000;
-            thread->m_context.reg_15 = startaddr;
-            thread->m_context.pc = startaddr;
-            thread->m_context.sp = 0x10000000;
-			thread->m_context.cpsr = 0x1F;
-            process->AddThread(thread);
-
-            free(rodata);
-            free(data);
-            free(code);
-            free(sec);
+    m->text = CopySegment(sec, realcodesize);
+    m->rodata = CopySegment(sec + realcodesize, realrodatasize);
+    m->data = CopySegment(sec + realcodesize + realrodatasize, realdatasize);
+    free(sec);
+    if (!m->text || !m->rodata || !m->data) {
+        XDSERROR("code segment allocation failed.");
+        return;
+    }
+    m->loaded = true;
+}
 
-            *out_offset = ftell(fd);
+static void LoadModuleThread(FILE* fd, FirmModule* m)
+{
+    LoadModule(fd, m);
+    LogReleaseThread();
+}
+
+static KProcess* CreateModuleProcess(FirmModule& m, KKernel* Kernel)
+{
+    exheader_header& ex = m.ncch.exheader;
+    char namereal[9];
+    strncpy(namereal, (char*)ex.codesetinfo.name, 9);
+
+    KCodeSet* Codeset = new KCodeSet(
+        m.text, AlignPage(Read32(ex.codesetinfo.text.codesize)) / 0x1000,
+        m.rodata, AlignPage(Read32(ex.codesetinfo.ro.codesize)) / 0x1000,
+        m.data, AlignPage(Read32(ex.codesetinfo.data.codesize)) / 0x1000,
+        AlignPage(Read32(ex.codesetinfo.bsssize)) / 0x1000,
+        Read64(m.ncch.header.programid),
+        namereal
+        );
+
+    KProcess* process = new KProcess(Codeset, 28, (u32*)ex.arm11kernelcaps.descriptors, Kernel,true);
+
+    //Start the process
+
+    //map stack
+    u32 unused;
+    u32 stacksize = Read32(ex.codesetinfo.stacksize);
+    process->getMemoryMap()->ControlMemory(&unused, 0x10000000 - stacksize, 0, stacksize, OPERATION_COMMIT, PERMISSION_RW);
+
+    KThread * thread = new KThread(SERVICECORE,process);
+    u32 startaddr = (process->m_exheader_flags & (1 << 12)) ? 0x14000000 : 0x00100000;
+    thread->m_context.reg_15 = startaddr;
+    thread->m_context.pc = startaddr;
+    thread->m_context.sp = 0x10000000;
+    thread->m_context.cpsr = 0x1F;
+    process->AddThread(thread);
+
+    //no need to register them with fs and sm the pm dose that on its own core stuff always dose that correctly
+    return process;
+}
 
-            //no need to register them with fs and sm the pm dose that on its own core stuff always dose that correctly
-            return process;
+static void FreeModule(FirmModule& m)
+{
+    free(m.text);
+    free(m.rodata);
+    free(m.data);
+}
+
+struct TitleContent {
+    std::string path; // .app of the content the TMD names first
+    u64 size;
+};
+
+// every title in NAND/title, it is scanned once and titles that are missing are looked for again
+static std::unordered_map<u64, TitleContent> s_titles;
+static bool s_titles_scanned = false;
+
+static bool ReadTMDContentIndex(const char* path, u32& index_out)
+{
+    FILE* fd = fopen(path, "rb");
+    if (fd == NULL)
+        return false;
+    u8 temp[4];
+    if (fread(temp, 4, 1, fd) != 1)
+    {
+        XDSERROR("reading tmd Signature Type");
+        fclose(fd);
+        return false;
+    }
+    u32 Signature_Type = Read32revers(temp);
+    u32 y;
+    switch (Signature_Type)
+    {
+    case 0x010000:
+        y = 0x240;
+        break;
+    case 0x010001:
+        y = 0x140;
+        break;
+    case 0x010002:
+        y = 0x80;
+        break;
+    case 0x010003:
+        y = 0x240;
+        break;
+    case 0x010004:
+        y = 0x140;
+        break;
+    case 0x010005:
+        y = 0x80;
+        break;
+    default:
+        LOG("unknown Signature Type fallback");
+        y = 0x140;
+        break;
+    }
+    if (fseek(fd, y + 0x9C4, SEEK_SET) != 0 || fread(temp, 4, 1, fd) != 1)
+    {
+        XDSERROR("reading tmd content index %s", path);
+        fclose(fd);
+        return false;
+    }
+    index_out = Read32revers(temp);
+    fclose(fd);
+    return true;
+}
+
+// the whole name has to be 8 hex digits, 00040138_old or a copy with .bak must not take the place of the title
+static bool ParseHex32(const std::string& name, u32& out)
+{
+    if (name.size() != 8)
+        return false;
+    for (u32 i = 0; i < 8; i++)
+    {
+        if (!isxdigit((unsigned char)name[i]))
+            return false;
+    }
+    out = strtoul(name.c_str(), NULL, 16);
+    return true;
+}
+
+static void IndexTitle(u32 titlehigh, u32 titlelow, const std::string& dir)
+{
+    std::string content = dir + "/content";
+    std::vector<std::string> names;
+    if (!Common::ListDirectory(content.c_str(), names))
+        return;
+
+    // the TMD with the lowest number is the one that counts
+    bool found = false;
+    u32 tmd = 0;
+    for (u32 i = 0; i < names.size(); i++)
+    {
+        u32 number;
+        if (names[i].size() == 12 && names[i].compare(8, 4, ".tmd") == 0 && ParseHex32(names[i].substr(0, 8), number) && (!found || number < tmd))
+        {
+            tmd = number;
+            found = true;
         }
     }
-    return NULL;
+    if (!found)
+        return;
+
+    char string[0x100];
+    u32 index;
+    snprintf(string, 0x100, "%s/%08x.tmd", content.c_str(), tmd);
+    if (!ReadTMDContentIndex(string, index))
+        return;
+    snprintf(string, 0x100, "%s/%08x.app", content.c_str(), index);
+
+    struct stat st;
+    if (stat(string, &st) != 0)
+    {
+        XDSERROR("opening the container %s", string);
+        return;
+    }
+    TitleContent& title = s_titles[(u64)titlehigh << 32 | titlelow];
+    title.path = string;
+    title.size = st.st_size;
+    LOGDEBUG("title %08x%08x is %s (%" PRIu64 " bytes)", titlehigh, titlelow, title.path.c_str(), title.size);
 }
-FILE* openapp(u32 titlehigh, u32 titlelow) //used by pm
+
+static void IndexTitles()
 {
-    for (u32 i = 0; i < 0x1000; i++) //TODO search for the correct tmd that needs to be impr that is also only a hack normaly the data is loaded from .firm not from the FS
+    std::vector<std::string> highs;
+    Common::ListDirectory("./NAND/title", highs);
+    for (u32 i = 0; i < highs.size(); i++)
     {
-        char string[0x100];
-#if EMU_PLATFORM == PLATFORM_WINDOWS
-		sprintf_s(string, 0x100, "./NAND/title/%08X/%08X/content/%08x.tmd", titlehigh, titlelow, i);
-#else
-        snprintf(string, 0x100, "./NAND/title/%08X/%08X/content/%08x.tmd", titlehigh, titlelow, i);
-#endif
-        FILE* fd = fopen(string, "rb");
-        if (fd != NULL)
+        u32 titlehigh;
+        std::vector<std::string> lows;
+        std::string dir = "./NAND/title/" + highs[i];
+        if (!ParseHex32(highs[i], titlehigh) || !Common::ListDirectory(dir.c_str(), lows))
+            continue;
+        for (u32 j = 0; j < lows.size(); j++)
         {
-            u8 temp[4];
-            if (fread(temp, 4, 1, fd) != 1)
-            {
-                XDSERROR("reading tmd Signature Type");
-                return NULL;
-            }
-            u32 Signature_Type = Read32revers(temp);
-            u32 y;
-            switch (Signature_Type)
-            {
-            case 0x010000:
-                y = 0x240;
-                break;
-            case 0x010001:
-                y = 0x140;
-                break;
-            case 0x010002:
-                y = 0x80;
-                break;
-            case 0x010003:
-                y = 0x240;
-                break;
-            case 0x010004:
-                y = 0x140;
-                break;
-            case 0x010005:
-                y = 0x80;
-                break;
-            default:
-                LOG("unknown Signature Type fallback");
-                y = 0x140;
-                break;
-            }
-            if (fseek(fd, y + 0x9C4, SEEK_SET) != 0)
-            {
-                XDSERROR("reading tmd Signature Type");
-                return NULL;
-            }
-            if (fread(temp, 4, 1, fd) != 1)
-            {
-                XDSERROR("reading tmd Signature Type");
-                return NULL;
-            }
-            u32 index = Read32revers(temp);
-            fclose(fd);
-
-#if EMU_PLATFORM == PLATFORM_WINDOWS
-			sprintf_s(string, 0x100, "./NAND/title/%08x/%08x/content/%08x.app", titlehigh, titlelow, index);
-#else
-			snprintf(string, 0x100, "./NAND/title/%08x/%08x/content/%08x.app", titlehigh, titlelow, index);
-#endif
-            fd = fopen(string, "rb");
-            if (fd == NULL)
-            {
-                XDSERROR("opening the container %s", string);
-                return NULL;
-            }
-            return fd;
+            u32 titlelow;
+            if (ParseHex32(lows[j], titlelow))
+                IndexTitle(titlehigh, titlelow, dir + "/" + lows[j]);
         }
     }
-    return NULL;
+    LOG("%u titles found in NAND/title", (u32)s_titles.size());
 }
 
-s64 FindRomFSOffset(FILE* fd, char* name, u64 &out_size, u8* hash_out)
+// the parsed headers of every content that was opened, by path
+static std::unordered_map<std::string, NcchContainer*> s_containers;
+
+static TitleContent* FindTitle(u32 titlehigh, u32 titlelow)
 {
-	if (fd == NULL)
-	{
-		return -1;
-	}
-	fseek(fd, 0, SEEK_SET);
-
-
-	//open the container
-	exheader_header ex;
-	ctr_ncchheader loader_h;
-	u32 ncch_off = 0;
-
-	// Read header.
-	if (fread(&loader_h, sizeof(loader_h), 1, fd) != 1) {
-		XDSERROR("failed to read header.");
-		return -1;
-	}
-	// Load NCCH
-	if (memcmp(&loader_h.magic, "NCCH", 4) != 0) {
-		XDSERROR("invalid magic.. wrong file?");
-		return -1;
-	}
-
-	// Read Exheader.
-	if (fread(&ex, sizeof(ex), 1, fd) != 1) {
-		XDSERROR("failed to read exheader.");
-		return -1;
-	}
-
-	// Read ExeFS.
-	u32 exefs_off = Read32(loader_h.romfsoffset) * 0x200;
-	out_size = Read32(loader_h.romfssize) * 0x200;
-
-	return exefs_off;
+    if (!s_titles_scanned)
+    {
+        IndexTitles();
+        s_titles_scanned = true;
+    }
+    u64 id = (u64)titlehigh << 32 | titlelow;
+    auto it = s_titles.find(id);
+    if (it == s_titles.end())
+    {
+        // it may have been installed since the scan
+        char dir[0x100];
+        snprintf(dir, 0x100, "./NAND/title/%08X/%08X", titlehigh, titlelow);
+        IndexTitle(titlehigh, titlelow, dir);
+        it = s_titles.find(id);
+        if (it == s_titles.end())
+            return NULL;
+    }
+    return &it->second;
 }
 
+static FILE* OpenTitle(u32 titlehigh, u32 titlelow, TitleContent*& title)
+{
+    title = FindTitle(titlehigh, titlelow);
+    if (title == NULL)
+        return NULL;
+    FILE* fd = fopen(title->path.c_str(), "rb");
+    if (fd == NULL)
+    {
+        XDSERROR("opening the container %s", title->path.c_str());
+        auto it = s_containers.find(title->path);
+        if (it != s_containers.end())
+        {
+            delete it->second;
+            s_containers.erase(it);
+        }
+        s_titles.erase((u64)titlehigh << 32 | titlelow);
+        title = NULL;
+    }
+    return fd;
+}
 
-s64 FindTableOffset(FILE* fd,char* name,u64 &out_size, u8* hash_out)
+FILE* openapp(u32 titlehigh, u32 titlelow) //used by pm
 {
-	if (fd == NULL)
-	{
-		return -1;
-	}
-	fseek(fd, 0, SEEK_SET);
-
-
-	//open the container
-	exheader_header ex;
-	ctr_ncchheader loader_h;
-	u32 ncch_off = 0;
-
-	// Read header.
-	if (fread(&loader_h, sizeof(loader_h), 1, fd) != 1) {
-		XDSERROR("failed to read header.");
-		return -1;
-	}
-	// Load NCCH
-	if (memcmp(&loader_h.magic, "NCCH", 4) != 0) {
-		XDSERROR("invalid magic.. wrong file?");
-		return -1;
-	}
-
-	// Read Exheader.
-	if (fread(&ex, sizeof(ex), 1, fd) != 1) {
-		XDSERROR("failed to read exheader.");
-		return -1;
-	}
-
-	// Read ExeFS.
-	u32 exefs_off = Read32(loader_h.exefsoffset) * 0x200;
-	u32 exefs_sz = Read32(loader_h.exefssize) * 0x200;
-
-	if (fseek(fd, exefs_off + ncch_off, SEEK_SET) != 0)
-	{
-		XDSERROR("failed to seek.");
-		return -2;
-	}
-
-	exefs_header eh;
-	if (fread(&eh, sizeof(eh), 1, fd) != 1) {
-		XDSERROR("failed to read ExeFS header.");
-		return -1;
-	}
-
-	for (u32 i = 0; i < 8; i++) {
-		u32 sec_size = Read32(eh.section[i].size);
-		u32 sec_off = Read32(eh.section[i].offset);
-		out_size = sec_size;
-		if (sec_size == 0)
-			continue;
-
-		eh.section[i].name[7] = '\0';
-
-		if (hash_out != NULL)
-		{
-			memcpy(hash_out, eh.hashes[7-i], 0x20);
-		}
-
-		//sec_off = 0;
-
-		if (strcmp((char*)eh.section[i].name, name) == 0) {
-			return exefs_off + sizeof(eh) + sec_off;
-		}
-	}
-	XDSERROR("finding section");
-	return -1;
+    TitleContent* title;
+    return OpenTitle(titlehigh, titlelow, title);
+}
+
+FILE* openapp(u32 titlehigh, u32 titlelow, const NcchContainer*& container)
+{
+    TitleContent* title;
+    container = NULL;
+    FILE* fd = OpenTitle(titlehigh, titlelow, title);
+    if (fd == NULL)
+        return NULL;
+
+    auto it = s_containers.find(title->path);
+    if (it != s_containers.end())
+    {
+        container = it->second;
+        return fd;
+    }
+    NcchContainer* c = new NcchContainer();
+    if (!ParseNcch(fd, 0, *c))
+    {
+        XDSERROR("parsing the container %s", title->path.c_str());
+        delete c;
+        return fd;
+    }
+    c->path = title->path;
+    s_containers[title->path] = c;
+    container = c;
+    return fd;
 }
 
 int Boot(KKernel* kernel)
 {
-    FILE* fd = openapp(0x00040138, 0x00000002);//this is firm
+    const NcchContainer* container;
+    FILE* fd = openapp(0x00040138, 0x00000002, container);//this is firm
+    if (fd == NULL)
+    {
+        XDSERROR("finding firm");
+        return -1;
+    }
     //open the firm to extrect the core modules
-	u64 temp;
-	s64 sec_off = FindTableOffset(fd, ".firm", temp, NULL);
-    u32 out_offset;
-	if (sec_off > 0)
-	{
-		KProcess* process = Boot_LoadFileFast(fd, sec_off + 0x200, &out_offset, kernel);//The first is most likely the NCCH container but that may change I don't know how to detect the correct container so I just do it by a static offset TODO
-		for (int j = 0; j < 4; j++) //boot all 5
-		{
-			process = Boot_LoadFileFast(fd, (out_offset + 0x1FF)&~0x1FF, &out_offset, kernel);
-		}
-		fclose(fd);
-		return 0; //it worked
-	}
+    const ncch_section* firm = container ? container->FindSection(".firm") : NULL;
+    if (firm == NULL)
+    {
+        fclose(fd);
+        XDSERROR("finding .firm section");
+        return -1;
+    }
+
+    //The first is most likely the NCCH container but that may change I don't know how to detect the correct container so I just do it by a static offset TODO
+    FirmModule modules[FIRM_MODULES];
+    u32 count = 0;
+    u32 offset = (u32)firm->offset + 0x200;
+    while (count < FIRM_MODULES && FindModule(fd, offset, modules[count], &offset))
+    {
+        offset = (offset + 0x1FF)&~0x1FF;
+        count++;
+    }
+
+    // reading and decompressing is most of the work, the processes are created in order afterwards
+    std::thread workers[FIRM_MODULES];
+    for (u32 i = 0; i < count; i++)
+        workers[i] = std::thread(LoadModuleThread, fd, &modules[i]);
+    for (u32 i = 0; i < count; i++)
+        workers[i].join();
     fclose(fd);
-    XDSERROR("finding .firm section");
-    return -1;
-    XDSERROR("finding firm");
-    return -1;
 
+    for (u32 i = 0; i < count; i++)
+    {
+        if (modules[i].loaded)
+            CreateModuleProcess(modules[i], kernel);
+        FreeModule(modules[i]);
+    }
+    return 0; //it worked
 }
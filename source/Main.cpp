@@ -4,6 +4,8 @@
 #include "Kernel.h"
 #include "Gui.h"
 #include "Bootloader.h"
+#include "Hardware.h"
+#include "Process9.h"
 
 #include "citraimport/GPU/window/emu_window_glfw.h"
 
@@ -21,6 +23,35 @@ int main(int argc, char* argv[]) {
     size_t size = fread(code, 1, sizeof(code), fd);
     fclose(fd);*/
 
+	int cores = 1;
+	bool realtime = false;
+	double cpi = 1;
+	bool p9hle = false;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-nojit"))
+			dyncomjit = false;
+		if (!strcmp(argv[i], "-dyncomstats"))
+			dyncomstats = true;
+		if (!strcmp(argv[i], "-log") && i + 1 < argc) // -log "*:warning ipc:info"
+		{
+			if (!LogParseLevels(argv[++i]))
+				XDSERROR("invalid log levels %s", argv[i]);
+		}
+		if (!strcmp(argv[i], "-cores") && i + 1 < argc) // -cores 2, each core runs on its own host thread
+			cores = atoi(argv[++i]);
+		if (!strcmp(argv[i], "-cpi") && i + 1 < argc) // -cpi 0.5 runs twice the instructions per emulated second
+			cpi = atof(argv[++i]);
+		if (!strcmp(argv[i], "-realtime"))
+			realtime = true;
+		if (!strcmp(argv[i], "-p9hle")) // requests that pxi passes on unchanged go to Process9 without the FIFO
+			p9hle = true;
+		if (!strcmp(argv[i], "-watch") && i + 1 < argc) // -watch 1ff80000-1ff81fff:rw@process
+		{
+			if (KMemoryMap::AddWatch(argv[++i]) != Success)
+				XDSERROR("invalid memory watch %s", argv[i]);
+		}
+	}
+
 	//citra hacks
 
 	EmuWindow_GLFW window;
@@ -31,6 +62,10 @@ int main(int argc, char* argv[]) {
 
     //MainWindow* wndMain = new MainWindow();
 	mykernel = new KKernel();
+	mykernel->SetCoreCount(cores);
+	mykernel->SetRealTime(realtime);
+	mykernel->SetCyclesPerInstruction(cpi);
+	mykernel->m_p9->SetHLE(p9hle);
 
     Mem_Init(false);
     Mem_SharedMemInit();
@@ -47,5 +82,7 @@ extern "C" void citraFireInterrupt(int id)
 	mykernel->FireInterrupt(id);
 }
 bool novideo = true;
+bool dyncomjit = true;
+bool dyncomstats = false;
 extern "C" int citraPressedkey = 0;
 extern "C" bool citraSettingSkipGSP = true;
\ No newline at end of file
@@ -3,6 +3,10 @@
 KArmCore::KArmCore(KKernel* kernel) : m_kernel(kernel), m_cpu()
 {
     m_thread = NULL;
+    m_cpi = 256;
+    m_cycle_fraction = 0;
+    m_slice_start = 0;
+    m_in_slice = false;
 }
 void KArmCore::SetThread(KThread* thread)
 {
@@ -17,9 +21,40 @@ void KArmCore::SetThread(KThread* thread)
     m_cpu.LoadContext(m_thread->m_context);
     m_cpu.state->m_MemoryMap = &m_thread->m_owner->m_memory;
 }
-u64 KArmCore::RunCycles(uint cycles)
+KThread* KArmCore::GetThread()
 {
-    return m_cpu.Run(cycles);
+    return m_thread;
+}
+void KArmCore::ReleaseThread()
+{
+    if (m_thread)
+    {
+        m_cpu.SaveContext(m_thread->m_context);
+        m_thread = NULL;
+    }
+}
+u64 KArmCore::RunCycles(u64 cycles, u64 clock)
+{
+    // the cpu counts instructions, the clock counts cycles
+    u64 instrs = (cycles * 256 + m_cpi - 1) / m_cpi;
+    m_slice_start = clock;
+    m_in_slice = true;
+    u64 used = m_cpu.Run((int)instrs) * m_cpi + m_cycle_fraction;
+    m_in_slice = false;
+    m_cycle_fraction = used & 0xFF;
+    return used >> 8;
+}
+u64 KArmCore::GetClock()
+{
+    return m_slice_start + (((u64)m_cpu.state->SwiInstrs * m_cpi + m_cycle_fraction) >> 8);
+}
+bool KArmCore::InSlice()
+{
+    return m_in_slice;
+}
+void KArmCore::SetCyclesPerInstruction(u32 cpi)
+{
+    m_cpi = cpi;
 }
 void KArmCore::ReSchedule()
 {
@@ -29,11 +64,3 @@ void KArmCore::SetRegister(uint id, uint data)
 {
     m_cpu.SetReg(id, data);
 }
-void KArmCore::Addticks(int ticks)
-{
-	m_cpu.AddTicks(ticks);
-}
-s64 KArmCore::Getticks()
-{
-	return m_cpu.GetTicks();
-}
\ No newline at end of file
@@ -81,6 +81,7 @@ void ARM_DynCom::AddTicks(u64 ticks) {
 
 u64 ARM_DynCom::ExecuteInstructions(int num_instructions) {
     state->NumInstrsToExecute = num_instructions;
+    state->SwiInstrs = 0;
 
     // Dyncom only breaks on instruction dispatch. This only happens on every instruction when
     // executing one instruction at a time. Otherwise, if a block is being executed, more
@@ -105,10 +106,6 @@ void ARM_DynCom::SaveContext(ThreadContext& ctx) {
     ctx.reg_15 = state->Reg[15];
     ctx.mode = state->NextInstr;
 
-    //Dyncore
-	state->m_currentThread->m_owner->repretBuffersize = state->inst_buffsize;
-	state->m_currentThread->m_owner->repretBuffertop = state->inst_bufftop;
-
     ctx.NFlag = state->NFlag;
     ctx.ZFlag = state->ZFlag;
     ctx.CFlag = state->CFlag;
@@ -134,10 +131,9 @@ void ARM_DynCom::LoadContext(const ThreadContext& ctx) {
     state->NextInstr = ctx.mode;
 
     //Dyncore
-	state->inst_buf = state->m_currentThread->m_owner->repretBuffer;
-	state->inst_buffsize = state->m_currentThread->m_owner->repretBuffersize;
-	state->inst_bufftop = state->m_currentThread->m_owner->repretBuffertop;
+	state->inst_arena = state->m_currentThread->m_owner->CreamBuffer;
 	state->CreamCache = state->m_currentThread->m_owner->CreamCache;
+	state->m_jit = state->m_currentThread->m_owner->m_jit;
 
     state->NFlag = ctx.NFlag;
     state->ZFlag = ctx.ZFlag;
@@ -0,0 +1,89 @@
+// Copyright 2015 XDS/3dmoo team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "Common.h"
+#include "arm/dyncom/arm_dyncom_arena.h"
+
+std::atomic<u32> CreamArena::s_total_chunks(0);
+
+CreamArena::CreamArena()
+{
+    memset(m_chunks, 0, sizeof(m_chunks));
+    m_chunks[0] = (char*)malloc(CHUNK_SIZE);
+    if (m_chunks[0] == NULL) {
+        XDSERROR("out of memory for the cream arena");
+        exit(1);
+    }
+    s_total_chunks++;
+    m_count = 1;
+    m_current = 0;
+    m_top = 0;
+    m_block = 0;
+    m_recycled = 0;
+    m_flushes = 0;
+}
+
+CreamArena::~CreamArena()
+{
+    for (u32 i = 0; i < m_count; i++)
+        free(m_chunks[i]);
+    s_total_chunks -= m_count;
+}
+
+int CreamArena::NextChunk()
+{
+    u32 block_size = m_top - m_block;
+    char* block = m_chunks[m_current] + m_block;
+    int ret;
+
+    if (s_total_chunks >= MAX_TOTAL_CHUNKS && m_count > 1) {
+        // the block has to be saved before its chunk is freed
+        if (m_current != 0)
+            memcpy(m_chunks[0], block, block_size);
+        else
+            memmove(m_chunks[0], block, block_size);
+        for (u32 i = 1; i < m_count; i++) {
+            free(m_chunks[i]);
+            m_chunks[i] = NULL;
+        }
+        s_total_chunks -= m_count - 1;
+        m_count = 1;
+        m_current = 0;
+        m_block = 0;
+        m_top = block_size;
+        m_flushes++;
+        return FLUSHED;
+    }
+
+    char* chunk = NULL;
+    if (m_count < MAX_CHUNKS && s_total_chunks < MAX_TOTAL_CHUNKS)
+        chunk = (char*)malloc(CHUNK_SIZE);
+    if (chunk) {
+        m_chunks[m_count] = chunk;
+        m_current = m_count++;
+        s_total_chunks++;
+        ret = GREW;
+    } else {
+        // chunks are filled in order, the next one holds the oldest blocks
+        m_current = (m_current + 1) % m_count;
+        m_recycled++;
+        ret = (int)m_current;
+    }
+
+    memmove(m_chunks[m_current], block, block_size);
+    m_block = 0;
+    m_top = block_size;
+    return ret;
+}
+
+CreamArenaStats CreamArena::GetStats() const
+{
+    CreamArenaStats stats;
+    stats.chunks = m_count;
+    // chunks are only left behind once they are full
+    stats.used = (u64)(m_count - 1) * CHUNK_SIZE + m_top;
+    stats.recycled = m_recycled;
+    stats.flushes = m_flushes;
+    return stats;
+}
@@ -0,0 +1,89 @@
+// Copyright 2015 XDS/3dmoo team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common.h"
+#include <atomic>
+
+struct CreamArenaStats {
+    u32 chunks;   // chunks currently allocated
+    u64 used;     // bytes handed out from the allocated chunks
+    u64 recycled; // chunks that were reused while full
+    u64 flushes;  // times the whole arena was dropped
+};
+
+/**
+ * Holds the creams of one process. Host memory is taken in chunks as translation goes on. Creams are
+ * addressed by handles (chunk << CHUNK_SHIFT | offset) so one chunk can be reused without touching
+ * the others. A block never spans two chunks, the interpreter walks its creams by offset.
+ *
+ * Once a process owns MAX_CHUNKS the oldest chunk is reused, once all processes together own
+ * MAX_TOTAL_CHUNKS the process that needs more drops everything but its first chunk.
+ */
+class CreamArena {
+public:
+    static const u32 CHUNK_SHIFT = 20;
+    static const u32 CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static const u32 CHUNK_MASK = CHUNK_SIZE - 1;
+    static const u32 MAX_CHUNKS = 64;
+    static const u32 MAX_TOTAL_CHUNKS = 256;
+
+    /// Returned by NextChunk when nothing was dropped
+    static const int GREW = -1;
+    /// Returned by NextChunk when every handle of this arena got invalid
+    static const int FLUSHED = -2;
+
+    CreamArena();
+    ~CreamArena();
+
+    /// Marks the current top as the start of a new block
+    void BeginBlock() {
+        m_block = m_top;
+    }
+
+    /// Handle of the block that was started last, it may have moved since BeginBlock
+    int GetBlock() const {
+        return (int)(m_current << CHUNK_SHIFT | m_block);
+    }
+
+    /// Returns the handle of size free bytes, the caller has to make room with NextChunk first
+    int Alloc(u32 size) {
+        int handle = (int)(m_current << CHUNK_SHIFT | m_top);
+        m_top += size;
+        return handle;
+    }
+
+    bool Fits(u32 size) const {
+        return m_top + size <= CHUNK_SIZE;
+    }
+
+    /// Start of the chunk a handle lives in, index it with (handle & CHUNK_MASK)
+    char* GetChunk(int handle) const {
+        return m_chunks[(u32)handle >> CHUNK_SHIFT];
+    }
+
+    char* Get(int handle) const {
+        return GetChunk(handle) + (handle & CHUNK_MASK);
+    }
+
+    /**
+     * Continues in another chunk and moves the open block there
+     * @return GREW, FLUSHED or the index of the chunk that was reused, handles in it are invalid
+     */
+    int NextChunk();
+
+    CreamArenaStats GetStats() const;
+
+private:
+    char* m_chunks[MAX_CHUNKS];
+    u32 m_count;   // allocated chunks
+    u32 m_current; // chunk that is filled
+    u32 m_top;     // first free byte in the current chunk
+    u32 m_block;   // start of the open block in the current chunk
+    u64 m_recycled;
+    u64 m_flushes;
+
+    static std::atomic<u32> s_total_chunks; // the arenas of processes on different cores change it at once
+};
@@ -0,0 +1,138 @@
+// Copyright 2015 XDS/3dmoo team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstring>
+
+#include "Common.h"
+
+struct BlockTableStats {
+    u64 lookups;
+    u64 hits;
+    u64 misses;
+};
+
+/**
+ * Maps guest addresses to translated blocks. The address is split into a directory, a table and a
+ * page index, so a lookup is three array loads. Pages are only allocated when a block is inserted.
+ * Slots are 2 bytes apart so thumb blocks fit as well. A table belongs to one process and is only
+ * used by the core of that process, other cores queue their changes with KProcess::InvalidateCode.
+ */
+template<typename T> class BlockTable {
+public:
+    /// @param empty Value returned for addresses without a block
+    explicit BlockTable(T empty) : m_empty(empty) {
+        memset(m_dir, 0, sizeof(m_dir));
+        memset(&m_stats, 0, sizeof(m_stats));
+        m_generation = 0;
+    }
+
+    ~BlockTable() {
+        Clear();
+    }
+
+    T Find(u32 addr) {
+        m_stats.lookups++;
+        Table* table = m_dir[addr >> 22];
+        if (table) {
+            Page* page = table->pages[(addr >> 12) & 0x3FF];
+            if (page) {
+                T& slot = page->slots[(addr & 0xFFF) >> 1];
+                if (!(slot == m_empty)) {
+                    m_stats.hits++;
+                    return slot;
+                }
+            }
+        }
+        m_stats.misses++;
+        return m_empty;
+    }
+
+    void Insert(u32 addr, T value) {
+        Table*& table = m_dir[addr >> 22];
+        if (!table) {
+            table = new Table;
+            memset(table, 0, sizeof(Table));
+        }
+        Page*& page = table->pages[(addr >> 12) & 0x3FF];
+        if (!page) {
+            page = new Page;
+            for (u32 i = 0; i < SLOTS_PER_PAGE; i++)
+                page->slots[i] = m_empty;
+        }
+        page->slots[(addr & 0xFFF) >> 1] = value;
+    }
+
+    /// Forgets every block that starts in the page containing addr
+    void ClearPage(u32 addr) {
+        Table* table = m_dir[addr >> 22];
+        if (!table)
+            return;
+        Page*& page = table->pages[(addr >> 12) & 0x3FF];
+        if (!page)
+            return;
+        delete page;
+        page = NULL;
+        m_generation++;
+    }
+
+    /// Forgets every block for which pred(block) is true, this walks all pages
+    template<typename Pred> void RemoveIf(Pred pred) {
+        for (u32 i = 0; i < DIR_SIZE; i++) {
+            Table* table = m_dir[i];
+            if (!table)
+                continue;
+            for (u32 j = 0; j < TABLE_SIZE; j++) {
+                Page* page = table->pages[j];
+                if (!page)
+                    continue;
+                for (u32 k = 0; k < SLOTS_PER_PAGE; k++) {
+                    if (!(page->slots[k] == m_empty) && pred(page->slots[k]))
+                        page->slots[k] = m_empty;
+                }
+            }
+        }
+        m_generation++;
+    }
+
+    void Clear() {
+        for (u32 i = 0; i < DIR_SIZE; i++) {
+            Table* table = m_dir[i];
+            if (!table)
+                continue;
+            for (u32 j = 0; j < TABLE_SIZE; j++)
+                delete table->pages[j];
+            delete table;
+            m_dir[i] = NULL;
+        }
+        m_generation++;
+    }
+
+    /// Changes whenever blocks are removed, anything that points at blocks has to check it
+    u32 GetGeneration() const {
+        return m_generation;
+    }
+
+    const BlockTableStats& GetStats() const {
+        return m_stats;
+    }
+
+private:
+    static const u32 DIR_SIZE = 0x400;
+    static const u32 TABLE_SIZE = 0x400;
+    static const u32 SLOTS_PER_PAGE = 0x800;
+
+    struct Page {
+        T slots[SLOTS_PER_PAGE];
+    };
+    struct Table {
+        Page* pages[TABLE_SIZE];
+    };
+
+    Table* m_dir[DIR_SIZE];
+    T m_empty;
+    BlockTableStats m_stats;
+    u32 m_generation; // plain, it is only read and changed on the core of the process
+};
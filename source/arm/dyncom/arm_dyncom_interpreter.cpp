@@ -730,11 +730,19 @@ typedef struct _eor_inst {
     shtop_fp_t shtop_func;
 } eor_inst;
 
+// Successor of a block that ends in a branch with a known target, lets the interpreter continue
+// there without going through DISPATCH. Links are dropped when the CreamCache generation changes.
+typedef struct _block_link {
+    unsigned int addr;
+    int ptr;
+    unsigned int gen;
+} block_link;
+
 typedef struct _bbl_inst {
     unsigned int L;
     int signed_immed_24;
-    unsigned int next_addr;
-    unsigned int jmp_addr;
+    block_link next;
+    block_link jmp;
 } bbl_inst;
 
 typedef struct _bx_inst {
@@ -1101,10 +1109,13 @@ typedef struct setend_inst {
 
 typedef struct _b_2_thumb {
     unsigned int imm;
+    block_link jmp;
 }b_2_thumb;
 typedef struct _b_cond_thumb {
     unsigned int imm;
     unsigned int cond;
+    block_link next;
+    block_link jmp;
 }b_cond_thumb;
 
 typedef struct _bl_1_thumb {
@@ -1112,6 +1123,7 @@ typedef struct _bl_1_thumb {
 }bl_1_thumb;
 typedef struct _bl_2_thumb {
     unsigned int imm;
+    block_link jmp;
 }bl_2_thumb;
 typedef struct _blx_1_thumb {
     unsigned int imm;
@@ -1128,16 +1140,26 @@ typedef struct _pkh_inst {
 typedef arm_inst * ARM_INST_PTR;
 
 inline void *AllocBuffer(ARMul_State* cpu,unsigned int size) {
-    int start = cpu->inst_bufftop;
-    cpu->inst_bufftop += size;
-    if (cpu->inst_bufftop > cpu->inst_buffsize) {
-        XDSERROR("inst_buf is full");
-        CITRA_IGNORE_EXIT(-1);
+    CreamArena* arena = cpu->inst_arena;
+    if (unlikely(!arena->Fits(size))) {
+        int dropped = arena->NextChunk();
+        if (dropped == CreamArena::FLUSHED) {
+            cpu->CreamCache->Clear();
+        } else if (dropped != CreamArena::GREW) {
+            cpu->CreamCache->RemoveIf([dropped](int start) {
+                return (start >> CreamArena::CHUNK_SHIFT) == dropped;
+            });
+        }
     }
-    return (void *)&cpu->inst_buf[start];
+    return (void *)arena->Get(arena->Alloc(size));
 }
 
 int CondPassed(ARMul_State* cpu, unsigned int cond) {
+    // armemu.h has these for its own state
+    #undef NFLAG
+    #undef ZFLAG
+    #undef CFLAG
+    #undef VFLAG
     #define NFLAG        cpu->NFlag
     #define ZFLAG        cpu->ZFlag
     #define CFLAG        cpu->CFlag
@@ -1354,6 +1376,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(and)(ARMul_State* cpu,unsigned int ins
 }
 static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(ARMul_State* cpu,unsigned int inst, int index)
 {
+    #undef POSBRANCH
+    #undef NEGBRANCH
     #define POSBRANCH ((inst & 0x7fffff) << 2)
     #define NEGBRANCH ((0xff000000 |(inst & 0xffffff)) << 2)
 
@@ -1371,6 +1395,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(ARMul_State* cpu,unsigned int ins
 
     inst_cream->L      = BIT(inst, 24);
     inst_cream->signed_immed_24 = BIT(inst, 23) ? NEGBRANCH : POSBRANCH;
+    inst_cream->next.ptr = -1;
+    inst_cream->jmp.ptr = -1;
 
     return inst_base;
 }
@@ -3191,6 +3217,7 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_2_thumb)(ARMul_State* cpu,unsigned i
     b_2_thumb *inst_cream = (b_2_thumb *)inst_base->component;
 
     inst_cream->imm = ((tinst & 0x3FF) << 1) | ((tinst & (1 << 10)) ? 0xFFFFF800 : 0);
+    inst_cream->jmp.ptr = -1;
 
     inst_base->idx = index;
     inst_base->br  = DIRECT_BRANCH;
@@ -3205,6 +3232,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_cond_thumb)(ARMul_State* cpu,unsigne
 
     inst_cream->imm  = (((tinst & 0x7F) << 1) | ((tinst & (1 << 7)) ?    0xFFFFFF00 : 0));
     inst_cream->cond = ((tinst >> 8) & 0xf);
+    inst_cream->next.ptr = -1;
+    inst_cream->jmp.ptr = -1;
     inst_base->idx   = index;
     inst_base->br    = DIRECT_BRANCH;
 
@@ -3228,6 +3257,7 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bl_2_thumb)(ARMul_State* cpu,unsigned
     bl_2_thumb *inst_cream = (bl_2_thumb *)inst_base->component;
 
     inst_cream->imm = (tinst & 0x07FF) << 1;
+    inst_cream->jmp.ptr = -1;
 
     inst_base->idx = index;
     inst_base->br  = DIRECT_BRANCH;
@@ -3551,19 +3581,13 @@ const transop_fp_t arm_instruction_trans[] = {
 };
 
 static void insert_bb(ARMul_State * cpu,unsigned int addr, int start) {
-    (*(cpu->CreamCache))[addr] = start;
+    cpu->CreamCache->Insert(addr, start);
+    cpu->m_MemoryMap->WatchCode(addr);
 }
 
 static int find_bb(ARMul_State * cpu, unsigned int addr, int& start) {
-    int ret = -1;
-    bb_map::const_iterator it = cpu->CreamCache->find(addr);
-    if (it != cpu->CreamCache->end()) {
-        start = static_cast<int>(it->second);
-        ret = 0;
-    } else {
-        ret = -1;
-    }
-    return ret;
+    start = cpu->CreamCache->Find(addr);
+    return start == -1 ? -1 : 0;
 }
 
 enum {
@@ -3646,7 +3670,7 @@ static int InterpreterTranslate(ARMul_State* cpu, int& bb_start, addr_t addr) {
     int ret = NON_BRANCH;
     int thumb = 0;
     int size = 0; // instruction size of basic block
-    bb_start = cpu->inst_bufftop;
+    cpu->inst_arena->BeginBlock();
 
     if (cpu->TFlag)
         thumb = THUMB;
@@ -3687,6 +3711,8 @@ translated:
         }
         ret = inst_base->br;
     };
+    // the block moves when it does not fit in the chunk it was started in
+    bb_start = cpu->inst_arena->GetBlock();
     insert_bb(cpu,pc_start, bb_start);
     return KEEP_GOING;
 }
@@ -3740,14 +3766,28 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
 #ifdef inst_debug 
 #define FETCH_INST      inst_deb(cpu);                                  \
                         if (inst_base->br != NON_BRANCH) goto DISPATCH; \
-                       inst_base = (arm_inst *)&cpu->inst_buf[ptr] 
+                       inst_base = (arm_inst *)&inst_buf[ptr] 
 #else
 #define FETCH_INST  if (inst_base->br != NON_BRANCH) goto DISPATCH; \
-                       inst_base = (arm_inst *)&cpu->inst_buf[ptr] 
+                       inst_base = (arm_inst *)&inst_buf[ptr] 
 #endif
 
     #define INC_PC(l) ptr += sizeof(arm_inst) + l
 
+    // Continues at the linked block if it is still the one for Reg[15], otherwise DISPATCH looks
+    // it up and links it for the next time.
+    #define GOTO_LINK(link)                                                     \
+        if ((link).ptr >= 0 && (link).addr == cpu->Reg[15] &&                   \
+            (link).gen == cpu->CreamCache->GetGeneration()) {                   \
+            CHECK_EXT_INT                                                       \
+            inst_buf = cpu->inst_arena->GetChunk((link).ptr);                   \
+            ptr = (link).ptr & CreamArena::CHUNK_MASK;                          \
+            inst_base = (arm_inst *)&inst_buf[ptr];                             \
+            GOTO_NEXT_INST;                                                     \
+        }                                                                       \
+        link_to = &(link);                                                      \
+        goto DISPATCH
+
 // GCC and Clang have a C++ extension to support a lookup table of labels. Otherwise, fallback to a
 // clunky switch statement.
 #if defined __GNUC__ || defined __clang__
@@ -3977,6 +4017,7 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
                        cpu->TFlag = (cpu->Cpsr >> 5) & 1;
 
     #define CurrentModeHasSPSR (cpu->Mode != SYSTEM32MODE) && (cpu->Mode != USER32MODE)
+    #undef PC
     #define PC (cpu->Reg[15])
     #define CHECK_EXT_INT if (!cpu->NirqSig && !(cpu->Cpsr & 0x80)) goto END;
 
@@ -4016,6 +4057,8 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
     unsigned int num_instrs = 0;
 
     int ptr;
+    char* inst_buf; // chunk of the running block, ptr is the offset in it
+    block_link* link_to = NULL;
 
     LOAD_NZCVT;
     DISPATCH:
@@ -4035,11 +4078,39 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
 
         phys_addr = cpu->Reg[15];
 
-        if (find_bb(cpu,cpu->Reg[15], ptr) == -1)
+#ifdef ARCHITECTURE_x86_64
+        if (cpu->m_jit && !cpu->TFlag) {
+            ARM_Jit::JitBlock block = cpu->m_jit->GetBlock(cpu, cpu->Reg[15], cpu->NumInstrsToExecute - num_instrs);
+            if (block) {
+                link_to = NULL;
+                num_instrs += block(cpu);
+                if (num_instrs >= cpu->NumInstrsToExecute)
+                    goto END;
+                goto DISPATCH;
+            }
+        }
+#endif
+
+        if (find_bb(cpu,cpu->Reg[15], ptr) == -1) {
+            // translating can reuse the chunk link_to points into
+            u32 generation = cpu->CreamCache->GetGeneration();
             if (InterpreterTranslate(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
                 goto END;
+            if (generation != cpu->CreamCache->GetGeneration())
+                link_to = NULL;
+        }
 
-        inst_base = (arm_inst *)&cpu->inst_buf[ptr];
+        // with the JIT enabled ARM code is not linked, the JIT should get the next try at it
+        if (link_to && (!cpu->m_jit || cpu->TFlag)) {
+            link_to->addr = cpu->Reg[15];
+            link_to->ptr = ptr;
+            link_to->gen = cpu->CreamCache->GetGeneration();
+        }
+        link_to = NULL;
+
+        inst_buf = cpu->inst_arena->GetChunk(ptr);
+        ptr &= CreamArena::CHUNK_MASK;
+        inst_base = (arm_inst *)&inst_buf[ptr];
         GOTO_NEXT_INST;
     }
     ADC_INST:
@@ -4141,18 +4212,18 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
     }
     BBL_INST:
     {
+        bbl_inst *inst_cream = (bbl_inst *)inst_base->component;
         if ((inst_base->cond == 0xe) || CondPassed(cpu, inst_base->cond)) {
-            bbl_inst *inst_cream = (bbl_inst *)inst_base->component;
             if (inst_cream->L) {
                 LINK_RTN_ADDR;
             }
             SET_PC;
             INC_PC(sizeof(bbl_inst));
-            goto DISPATCH;
+            GOTO_LINK(inst_cream->jmp);
         }
         cpu->Reg[15] += GET_INST_SIZE(cpu);
         INC_PC(sizeof(bbl_inst));
-        goto DISPATCH;
+        GOTO_LINK(inst_cream->next);
     }
     BIC_INST:
     {
@@ -6251,7 +6322,7 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
     SWI_INST:
     {
         if (inst_base->cond == 0xE || CondPassed(cpu, inst_base->cond)) {
-
+            cpu->SwiInstrs = num_instrs; // so the kernel can tell the time
             ProcessSwi(BITS(ARMul_LoadInstrS(cpu, cpu->Reg[15],4), 0, 24), state->Reg, state->m_currentThread);
         }
 
@@ -6718,19 +6789,19 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
         b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
         cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
         INC_PC(sizeof(b_2_thumb));
-        goto DISPATCH;
+        GOTO_LINK(inst_cream->jmp);
     }
     B_COND_THUMB:
     {
         b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
 
-        if(CondPassed(cpu, inst_cream->cond))
-            cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-        else
-            cpu->Reg[15] += 2;
-
         INC_PC(sizeof(b_cond_thumb));
-        goto DISPATCH;
+        if(CondPassed(cpu, inst_cream->cond)) {
+            cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
+            GOTO_LINK(inst_cream->jmp);
+        }
+        cpu->Reg[15] += 2;
+        GOTO_LINK(inst_cream->next);
     }
     BL_1_THUMB:
     {
@@ -6748,7 +6819,8 @@ unsigned InterpreterMainLoop(ARMul_State* state) {
         cpu->Reg[15] = (cpu->Reg[14] + inst_cream->imm);
         cpu->Reg[14] = tmp;
         INC_PC(sizeof(bl_2_thumb));
-        goto DISPATCH;
+        // the target depends on LR, the link checks it against Reg[15]
+        GOTO_LINK(inst_cream->jmp);
     }
     BLX_1_THUMB:
     {
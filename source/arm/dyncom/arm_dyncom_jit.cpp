@@ -0,0 +1,761 @@
+// Copyright 2015 XDS/3dmoo team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+#include <vector>
+
+#include "Kernel.h"
+
+#include "arm/dyncom/arm_dyncom_jit.h"
+
+#ifdef ARCHITECTURE_x86_64
+
+// skyeye names that clash with the emitter
+#undef NEG
+#undef ROR
+
+#include "citraimport/common/x64/abi.h"
+#include "citraimport/common/x64/emitter.h"
+
+using namespace Gen;
+
+#define JIT_CODE_SIZE (1024 * 1024 * 2)
+// flush everything once less than this is left, no block gets anywhere near that big
+#define JIT_CODE_RESERVE (1024 * 64)
+#define JIT_MAX_BLOCK_INSTRS 100
+
+// the state pointer and the base of LDM/STM live in callee saved registers so they survive calls
+// into the memory functions
+static const X64Reg STATE = Gen::RBX;
+static const X64Reg BASE = Gen::R12;
+
+#define MREG(r) MDisp(STATE, (int)(offsetof(ARMul_State, Reg) + (r) * sizeof(ARMword)))
+#define MFLAG(f) MDisp(STATE, (int)offsetof(ARMul_State, f))
+
+#undef BITS
+#undef BIT
+#define BITS(s, a, b) ((s << ((sizeof(s) * 8 - 1) - b)) >> (sizeof(s) * 8 - b + a - 1))
+#define BIT(s, n) ((s >> (n)) & 1)
+
+static u32 RotateRight(u32 value, u32 amount)
+{
+    amount &= 31;
+    if (amount == 0)
+        return value;
+    return (value >> amount) | (value << (32 - amount));
+}
+
+static u32 CountBits(u32 list)
+{
+    u32 count = 0;
+    for (; list; list &= list - 1)
+        count++;
+    return count;
+}
+
+class ARM_JitEmitter final : public Gen::XCodeBlock {
+public:
+    ARM_JitEmitter();
+
+    /// Returns the compiled block, nothing is emitted when the first instruction is unsupported
+    u8* Compile(ARMul_State* cpu, u32 addr, u32& num_instrs);
+
+private:
+    /// Returns false if the instruction is not supported, nothing is emitted in that case
+    bool CompileInstruction(u32 inst, u32 pc);
+
+    bool Compile_DataProcessing(u32 inst, u32 pc);
+    bool Compile_Multiply(u32 inst);
+    bool Compile_LoadStore(u32 inst, u32 pc);
+    bool Compile_LoadStoreExtra(u32 inst, u32 pc);
+    bool Compile_LoadStoreMultiple(u32 inst);
+    bool Compile_Branch(u32 inst, u32 pc);
+    bool Compile_BranchExchange(u32 inst, u32 pc);
+
+    bool Compile_ShifterOperand(u32 inst, bool carry);
+    void Compile_Address(u32 inst, u32 pc, bool offset_is_imm, u32 imm);
+    void Compile_CallLoad(const void* func);
+    void Compile_CallStore(const void* func, u32 rd);
+
+    FixupBranch Compile_ConditionCheck(u32 cond);
+    void Compile_SetPCAndExit(X64Reg reg);
+    void Compile_InterworkAndExit(X64Reg reg);
+
+    /// Jumps of instructions that wrote the PC, they all go to the block epilogue
+    std::vector<FixupBranch> m_exits;
+    /// Set once the current instruction ends the block
+    bool m_block_end;
+};
+
+// addresses the interpreter has to handle are cached as { nullptr, 0 }
+const ARM_Jit::BlockEntry ARM_Jit::s_no_entry = { nullptr, 0xFFFFFFFF };
+
+ARM_Jit::ARM_Jit() : m_blocks(s_no_entry)
+{
+    m_emitter = new ARM_JitEmitter();
+}
+
+ARM_Jit::~ARM_Jit()
+{
+    delete m_emitter;
+}
+
+void ARM_Jit::Clear()
+{
+    m_emitter->ClearCodeSpace();
+    m_blocks.Clear();
+}
+
+void ARM_Jit::InvalidatePage(u32 addr)
+{
+    m_blocks.ClearPage(addr);
+}
+
+const BlockTableStats& ARM_Jit::GetStats() const
+{
+    return m_blocks.GetStats();
+}
+
+ARM_Jit::JitBlock ARM_Jit::GetBlock(ARMul_State* cpu, u32 addr, u32 max_instrs)
+{
+    BlockEntry entry = m_blocks.Find(addr);
+    if (entry == s_no_entry) {
+        if (m_emitter->GetSpaceLeft() < JIT_CODE_RESERVE)
+            Clear();
+        entry.code = (JitBlock)m_emitter->Compile(cpu, addr, entry.num_instrs);
+        m_blocks.Insert(addr, entry);
+        cpu->m_MemoryMap->WatchCode(addr);
+    }
+    // blocks always run to the end, leave the rest of the slice to the interpreter
+    if (entry.num_instrs > max_instrs)
+        return nullptr;
+    return entry.code;
+}
+
+ARM_JitEmitter::ARM_JitEmitter()
+{
+    AllocCodeSpace(JIT_CODE_SIZE);
+}
+
+u8* ARM_JitEmitter::Compile(ARMul_State* cpu, u32 addr, u32& num_instrs)
+{
+    num_instrs = 0;
+
+    u8* start = const_cast<u8*>(GetCodePtr());
+    ABI_PushRegistersAndAdjustStack(BitSet32{ STATE, BASE }, 8);
+    MOV(64, R(STATE), R(ABI_PARAM1));
+
+    m_exits.clear();
+    m_block_end = false;
+
+    u32 pc = addr;
+    while (!m_block_end && num_instrs < JIT_MAX_BLOCK_INSTRS) {
+        u32 inst;
+        if (cpu->m_MemoryMap->Read32(pc, inst) != Success)
+            break;
+        if (!CompileInstruction(inst, pc))
+            break;
+        num_instrs++;
+        pc += 4;
+
+        // same as the interpreter, a block never crosses a page
+        if ((pc & 0xfff) == 0)
+            break;
+    }
+
+    if (num_instrs == 0) {
+        SetCodePtr(start);
+        return nullptr;
+    }
+
+    if (!m_block_end)
+        MOV(32, MREG(15), Imm32(pc));
+    for (FixupBranch& exit : m_exits)
+        SetJumpTarget(exit);
+
+    MOV(32, R(EAX), Imm32(num_instrs));
+    ABI_PopRegistersAndAdjustStack(BitSet32{ STATE, BASE }, 8);
+    RET();
+
+    return start;
+}
+
+bool ARM_JitEmitter::CompileInstruction(u32 inst, u32 pc)
+{
+    u32 cond = BITS(inst, 28, 31);
+    if (cond == 0xF)
+        return false;
+
+    const u8* inst_start = GetCodePtr();
+    FixupBranch skip;
+    if (cond != 0xE)
+        skip = Compile_ConditionCheck(cond);
+
+    bool ok;
+    if ((inst & 0x0FFFFFD0) == 0x012FFF10)
+        ok = Compile_BranchExchange(inst, pc);
+    else if ((inst & 0x0FC000F0) == 0x00000090)
+        ok = Compile_Multiply(inst);
+    else if ((inst & 0x0E000090) == 0x00000090)
+        ok = Compile_LoadStoreExtra(inst, pc);
+    else if ((inst & 0x0C000000) == 0x00000000)
+        ok = Compile_DataProcessing(inst, pc);
+    else if ((inst & 0x0C000000) == 0x04000000)
+        ok = Compile_LoadStore(inst, pc);
+    else if ((inst & 0x0E000000) == 0x08000000)
+        ok = Compile_LoadStoreMultiple(inst);
+    else if ((inst & 0x0E000000) == 0x0A000000)
+        ok = Compile_Branch(inst, pc);
+    else
+        ok = false;
+
+    if (!ok) {
+        SetCodePtr(const_cast<u8*>(inst_start));
+        m_block_end = false;
+        return false;
+    }
+
+    if (cond != 0xE) {
+        SetJumpTarget(skip);
+        // a skipped pc write still ends the block, it continues at the next instruction
+        if (m_block_end)
+            MOV(32, MREG(15), Imm32(pc + 4));
+    }
+    return true;
+}
+
+FixupBranch ARM_JitEmitter::Compile_ConditionCheck(u32 cond)
+{
+    // the flags are always kept as 0 or 1, the returned branch is taken when the condition fails
+    switch (cond) {
+    case 0x0: // EQ
+        CMP(32, MFLAG(ZFlag), Imm8(0));
+        return J_CC(CC_E, true);
+    case 0x1: // NE
+        CMP(32, MFLAG(ZFlag), Imm8(0));
+        return J_CC(CC_NE, true);
+    case 0x2: // CS
+        CMP(32, MFLAG(CFlag), Imm8(0));
+        return J_CC(CC_E, true);
+    case 0x3: // CC
+        CMP(32, MFLAG(CFlag), Imm8(0));
+        return J_CC(CC_NE, true);
+    case 0x4: // MI
+        CMP(32, MFLAG(NFlag), Imm8(0));
+        return J_CC(CC_E, true);
+    case 0x5: // PL
+        CMP(32, MFLAG(NFlag), Imm8(0));
+        return J_CC(CC_NE, true);
+    case 0x6: // VS
+        CMP(32, MFLAG(VFlag), Imm8(0));
+        return J_CC(CC_E, true);
+    case 0x7: // VC
+        CMP(32, MFLAG(VFlag), Imm8(0));
+        return J_CC(CC_NE, true);
+    case 0x8: // HI
+        MOV(32, R(EAX), MFLAG(ZFlag));
+        XOR(32, R(EAX), Imm8(1));
+        AND(32, R(EAX), MFLAG(CFlag));
+        return J_CC(CC_Z, true);
+    case 0x9: // LS
+        MOV(32, R(EAX), MFLAG(ZFlag));
+        XOR(32, R(EAX), Imm8(1));
+        AND(32, R(EAX), MFLAG(CFlag));
+        return J_CC(CC_NZ, true);
+    case 0xA: // GE
+        MOV(32, R(EAX), MFLAG(NFlag));
+        CMP(32, R(EAX), MFLAG(VFlag));
+        return J_CC(CC_NE, true);
+    case 0xB: // LT
+        MOV(32, R(EAX), MFLAG(NFlag));
+        CMP(32, R(EAX), MFLAG(VFlag));
+        return J_CC(CC_E, true);
+    case 0xC: // GT
+        MOV(32, R(EAX), MFLAG(NFlag));
+        XOR(32, R(EAX), MFLAG(VFlag));
+        OR(32, R(EAX), MFLAG(ZFlag));
+        return J_CC(CC_NZ, true);
+    default: // LE
+        MOV(32, R(EAX), MFLAG(NFlag));
+        XOR(32, R(EAX), MFLAG(VFlag));
+        OR(32, R(EAX), MFLAG(ZFlag));
+        return J_CC(CC_Z, true);
+    }
+}
+
+void ARM_JitEmitter::Compile_SetPCAndExit(X64Reg reg)
+{
+    MOV(32, MREG(15), R(reg));
+    m_exits.push_back(J(true));
+    m_block_end = true;
+}
+
+void ARM_JitEmitter::Compile_InterworkAndExit(X64Reg reg)
+{
+    // the lowest bit selects thumb mode like the interpreter does for LDR/LDM/BX
+    MOV(32, R(ECX), R(reg));
+    AND(32, R(ECX), Imm8(1));
+    MOV(32, MFLAG(TFlag), R(ECX));
+    AND(32, R(reg), Imm32(0xFFFFFFFE));
+    Compile_SetPCAndExit(reg);
+}
+
+bool ARM_JitEmitter::Compile_ShifterOperand(u32 inst, bool carry)
+{
+    // leaves the operand in ECX and the shifter carry out in DL
+    if (BIT(inst, 25)) {
+        u32 rotate = BITS(inst, 8, 11) * 2;
+        u32 value = RotateRight(BITS(inst, 0, 7), rotate);
+        MOV(32, R(ECX), Imm32(value));
+        if (carry) {
+            if (rotate == 0)
+                MOV(8, R(DL), MFLAG(CFlag));
+            else
+                MOV(8, R(DL), Imm8(value >> 31));
+        }
+        return true;
+    }
+
+    // register shifted by register is left to the interpreter
+    if (BIT(inst, 4))
+        return false;
+
+    u32 rm = BITS(inst, 0, 3);
+    u32 shift = BITS(inst, 5, 6);
+    u32 amount = BITS(inst, 7, 11);
+    if (rm == 15)
+        return false;
+    // LSR #32, ASR #32 and RRX
+    if (amount == 0 && shift != 0)
+        return false;
+
+    MOV(32, R(ECX), MREG(rm));
+    if (amount == 0) {
+        if (carry)
+            MOV(8, R(DL), MFLAG(CFlag));
+        return true;
+    }
+    switch (shift) {
+    case 0:
+        SHL(32, R(ECX), Imm8(amount));
+        break;
+    case 1:
+        SHR(32, R(ECX), Imm8(amount));
+        break;
+    case 2:
+        SAR(32, R(ECX), Imm8(amount));
+        break;
+    case 3:
+        ROR(32, R(ECX), Imm8(amount));
+        break;
+    }
+    // x86 leaves the last bit shifted out in CF, for ROR that is bit 31 of the result as on ARM
+    if (carry)
+        SETcc(CC_C, R(DL));
+    return true;
+}
+
+bool ARM_JitEmitter::Compile_DataProcessing(u32 inst, u32 pc)
+{
+    u32 opcode = BITS(inst, 21, 24);
+    bool S = BIT(inst, 20) != 0;
+    u32 rn = BITS(inst, 16, 19);
+    u32 rd = BITS(inst, 12, 15);
+
+    bool test = opcode >= 0x8 && opcode <= 0xB;
+    bool logical = opcode <= 0x1 || opcode == 0x8 || opcode == 0x9 || opcode >= 0xC;
+    bool uses_rn = opcode != 0xD && opcode != 0xF;
+
+    // MRS/MSR and friends
+    if (test && !S)
+        return false;
+    // mode changes
+    if (S && rd == 15)
+        return false;
+    // only ADR style pc reads, the interpreter is not consistent about them for the other ops
+    if (uses_rn && rn == 15 && !(BIT(inst, 25) && (opcode == 0x2 || opcode == 0x4)))
+        return false;
+
+    if (!Compile_ShifterOperand(inst, S && logical))
+        return false;
+
+    if (uses_rn) {
+        if (rn == 15)
+            MOV(32, R(EAX), Imm32(pc + 8));
+        else
+            MOV(32, R(EAX), MREG(rn));
+    }
+
+    switch (opcode) {
+    case 0x0: // AND
+    case 0x8: // TST
+        AND(32, R(EAX), R(ECX));
+        break;
+    case 0x1: // EOR
+    case 0x9: // TEQ
+        XOR(32, R(EAX), R(ECX));
+        break;
+    case 0x2: // SUB
+    case 0xA: // CMP
+        SUB(32, R(EAX), R(ECX));
+        break;
+    case 0x3: // RSB
+        SUB(32, R(ECX), R(EAX));
+        MOV(32, R(EAX), R(ECX));
+        break;
+    case 0x4: // ADD
+    case 0xB: // CMN
+        ADD(32, R(EAX), R(ECX));
+        break;
+    case 0x5: // ADC
+        BT(32, MFLAG(CFlag), Imm8(0));
+        ADC(32, R(EAX), R(ECX));
+        break;
+    case 0x6: // SBC
+        // x86 borrows where ARM carries
+        BT(32, MFLAG(CFlag), Imm8(0));
+        CMC();
+        SBB(32, R(EAX), R(ECX));
+        break;
+    case 0x7: // RSC
+        BT(32, MFLAG(CFlag), Imm8(0));
+        CMC();
+        SBB(32, R(ECX), R(EAX));
+        MOV(32, R(EAX), R(ECX));
+        break;
+    case 0xC: // ORR
+        OR(32, R(EAX), R(ECX));
+        break;
+    case 0xD: // MOV
+        MOV(32, R(EAX), R(ECX));
+        if (S)
+            TEST(32, R(EAX), R(EAX));
+        break;
+    case 0xE: // BIC
+        NOT(32, R(ECX));
+        AND(32, R(EAX), R(ECX));
+        break;
+    case 0xF: // MVN
+        NOT(32, R(ECX));
+        MOV(32, R(EAX), R(ECX));
+        if (S)
+            TEST(32, R(EAX), R(EAX));
+        break;
+    }
+
+    if (S) {
+        SETcc(CC_S, MFLAG(NFlag));
+        SETcc(CC_Z, MFLAG(ZFlag));
+        if (logical) {
+            MOV(8, MFLAG(CFlag), R(DL));
+        } else {
+            bool add = opcode == 0x4 || opcode == 0x5 || opcode == 0xB;
+            SETcc(add ? CC_C : CC_NC, MFLAG(CFlag));
+            SETcc(CC_O, MFLAG(VFlag));
+        }
+    }
+
+    if (test)
+        return true;
+    if (rd == 15)
+        Compile_SetPCAndExit(EAX);
+    else
+        MOV(32, MREG(rd), R(EAX));
+    return true;
+}
+
+bool ARM_JitEmitter::Compile_Multiply(u32 inst)
+{
+    u32 rd = BITS(inst, 16, 19);
+    u32 rn = BITS(inst, 12, 15);
+    u32 rs = BITS(inst, 8, 11);
+    u32 rm = BITS(inst, 0, 3);
+    if (rd == 15 || rn == 15 || rs == 15 || rm == 15)
+        return false;
+
+    MOV(32, R(EAX), MREG(rm));
+    IMUL(32, EAX, MREG(rs));
+    if (BIT(inst, 21))
+        ADD(32, R(EAX), MREG(rn));
+    if (BIT(inst, 20)) {
+        // only N and Z, C and V are left alone
+        TEST(32, R(EAX), R(EAX));
+        SETcc(CC_S, MFLAG(NFlag));
+        SETcc(CC_Z, MFLAG(ZFlag));
+    }
+    MOV(32, MREG(rd), R(EAX));
+    return true;
+}
+
+void ARM_JitEmitter::Compile_Address(u32 inst, u32 pc, bool offset_is_imm, u32 imm)
+{
+    // leaves the address in EAX, the offset is either imm or already in ECX
+    bool P = BIT(inst, 24) != 0;
+    bool U = BIT(inst, 23) != 0;
+    bool W = BIT(inst, 21) != 0;
+    u32 rn = BITS(inst, 16, 19);
+
+    if (rn == 15) {
+        // only the offset form gets here
+        u32 base = (pc & ~3) + 8;
+        if (offset_is_imm) {
+            MOV(32, R(EAX), Imm32(U ? base + imm : base - imm));
+            return;
+        }
+        MOV(32, R(EAX), Imm32(base));
+    } else {
+        MOV(32, R(EAX), MREG(rn));
+    }
+
+    if (offset_is_imm)
+        MOV(32, R(ECX), Imm32(imm));
+
+    if (P) {
+        if (U)
+            ADD(32, R(EAX), R(ECX));
+        else
+            SUB(32, R(EAX), R(ECX));
+        if (W)
+            MOV(32, MREG(rn), R(EAX));
+    } else {
+        MOV(32, R(EDX), R(EAX));
+        if (U)
+            ADD(32, R(EDX), R(ECX));
+        else
+            SUB(32, R(EDX), R(ECX));
+        MOV(32, MREG(rn), R(EDX));
+    }
+}
+
+void ARM_JitEmitter::Compile_CallLoad(const void* func)
+{
+    MOV(32, R(ABI_PARAM2), R(EAX));
+    MOV(64, R(ABI_PARAM1), R(STATE));
+    ABI_CallFunction(func);
+}
+
+void ARM_JitEmitter::Compile_CallStore(const void* func, u32 rd)
+{
+    MOV(32, R(ABI_PARAM2), R(EAX));
+    MOV(32, R(ABI_PARAM3), MREG(rd));
+    MOV(64, R(ABI_PARAM1), R(STATE));
+    ABI_CallFunction(func);
+}
+
+bool ARM_JitEmitter::Compile_LoadStore(u32 inst, u32 pc)
+{
+    bool reg_offset = BIT(inst, 25) != 0;
+    bool P = BIT(inst, 24) != 0;
+    bool B = BIT(inst, 22) != 0;
+    bool W = BIT(inst, 21) != 0;
+    bool L = BIT(inst, 20) != 0;
+    u32 rn = BITS(inst, 16, 19);
+    u32 rd = BITS(inst, 12, 15);
+    bool writeback = !P || W;
+
+    // media instructions
+    if (reg_offset && BIT(inst, 4))
+        return false;
+    // LDRT/STRT
+    if (!P && W)
+        return false;
+    if (writeback && (rn == 15 || rn == rd))
+        return false;
+    if (rd == 15 && (!L || B))
+        return false;
+
+    if (reg_offset) {
+        u32 rm = BITS(inst, 0, 3);
+        u32 shift = BITS(inst, 5, 6);
+        u32 amount = BITS(inst, 7, 11);
+        if (rm == 15 || (amount == 0 && shift != 0))
+            return false;
+        MOV(32, R(ECX), MREG(rm));
+        if (amount != 0) {
+            switch (shift) {
+            case 0:
+                SHL(32, R(ECX), Imm8(amount));
+                break;
+            case 1:
+                SHR(32, R(ECX), Imm8(amount));
+                break;
+            case 2:
+                SAR(32, R(ECX), Imm8(amount));
+                break;
+            case 3:
+                ROR(32, R(ECX), Imm8(amount));
+                break;
+            }
+        }
+        Compile_Address(inst, pc, false, 0);
+    } else {
+        Compile_Address(inst, pc, true, BITS(inst, 0, 11));
+    }
+
+    if (!L) {
+        Compile_CallStore(B ? (const void*)&ARMul_StoreByte : (const void*)&ARMul_StoreWordN, rd);
+        return true;
+    }
+
+    Compile_CallLoad(B ? (const void*)&ARMul_LoadByte : (const void*)&ARMul_LoadWordN);
+    if (rd == 15) {
+        Compile_InterworkAndExit(EAX);
+        return true;
+    }
+    MOV(32, MREG(rd), R(EAX));
+    return true;
+}
+
+bool ARM_JitEmitter::Compile_LoadStoreExtra(u32 inst, u32 pc)
+{
+    bool P = BIT(inst, 24) != 0;
+    bool I = BIT(inst, 22) != 0;
+    bool W = BIT(inst, 21) != 0;
+    bool L = BIT(inst, 20) != 0;
+    u32 rn = BITS(inst, 16, 19);
+    u32 rd = BITS(inst, 12, 15);
+    u32 sh = BITS(inst, 5, 6);
+    bool writeback = !P || W;
+
+    // SWP and the long multiplies
+    if (sh == 0)
+        return false;
+    // LDRD/STRD
+    if (!L && sh != 1)
+        return false;
+    if (!P && W)
+        return false;
+    if (writeback && (rn == 15 || rn == rd))
+        return false;
+    if (rd == 15)
+        return false;
+
+    if (I) {
+        Compile_Address(inst, pc, true, (BITS(inst, 8, 11) << 4) | BITS(inst, 0, 3));
+    } else {
+        u32 rm = BITS(inst, 0, 3);
+        if (rm == 15)
+            return false;
+        MOV(32, R(ECX), MREG(rm));
+        Compile_Address(inst, pc, false, 0);
+    }
+
+    if (!L) {
+        Compile_CallStore((const void*)&ARMul_StoreHalfWord, rd);
+        return true;
+    }
+
+    switch (sh) {
+    case 1: // LDRH
+        Compile_CallLoad((const void*)&ARMul_LoadHalfWord);
+        break;
+    case 2: // LDRSB
+        Compile_CallLoad((const void*)&ARMul_LoadByte);
+        MOVSX(32, 8, EAX, R(EAX));
+        break;
+    case 3: // LDRSH
+        Compile_CallLoad((const void*)&ARMul_LoadHalfWord);
+        MOVSX(32, 16, EAX, R(EAX));
+        break;
+    }
+    MOV(32, MREG(rd), R(EAX));
+    return true;
+}
+
+bool ARM_JitEmitter::Compile_LoadStoreMultiple(u32 inst)
+{
+    bool P = BIT(inst, 24) != 0;
+    bool U = BIT(inst, 23) != 0;
+    bool S = BIT(inst, 22) != 0;
+    bool W = BIT(inst, 21) != 0;
+    bool L = BIT(inst, 20) != 0;
+    u32 rn = BITS(inst, 16, 19);
+    u32 list = BITS(inst, 0, 15);
+    u32 count = CountBits(list);
+
+    // user bank transfers and exception returns
+    if (S)
+        return false;
+    if (rn == 15 || list == 0)
+        return false;
+    if (!L && BIT(list, 15))
+        return false;
+    if (L && W && BIT(list, rn))
+        return false;
+
+    // lowest register goes to the lowest address in all four modes
+    s32 start;
+    if (U)
+        start = P ? 4 : 0;
+    else
+        start = P ? -(s32)(count * 4) : -(s32)(count * 4) + 4;
+
+    MOV(32, R(BASE), MREG(rn));
+    if (start != 0)
+        ADD(32, R(BASE), Imm32((u32)start));
+
+    u32 offset = 0;
+    for (u32 i = 0; i < 15; i++) {
+        if (!BIT(list, i))
+            continue;
+        LEA(32, ABI_PARAM2, MDisp(BASE, offset));
+        if (L) {
+            MOV(64, R(ABI_PARAM1), R(STATE));
+            ABI_CallFunction((const void*)&ARMul_LoadWordN);
+            MOV(32, MREG(i), R(EAX));
+        } else {
+            // a stored base is always the old value, the writeback only happens below
+            MOV(32, R(ABI_PARAM3), MREG(i));
+            MOV(64, R(ABI_PARAM1), R(STATE));
+            ABI_CallFunction((const void*)&ARMul_StoreWordN);
+        }
+        offset += 4;
+    }
+
+    if (W) {
+        if (U)
+            ADD(32, MREG(rn), Imm32(count * 4));
+        else
+            SUB(32, MREG(rn), Imm32(count * 4));
+    }
+
+    if (BIT(list, 15)) {
+        LEA(32, ABI_PARAM2, MDisp(BASE, offset));
+        MOV(64, R(ABI_PARAM1), R(STATE));
+        ABI_CallFunction((const void*)&ARMul_LoadWordN);
+        Compile_InterworkAndExit(EAX);
+    }
+    return true;
+}
+
+bool ARM_JitEmitter::Compile_Branch(u32 inst, u32 pc)
+{
+    u32 offset = BITS(inst, 0, 23) << 2;
+    if (BIT(inst, 23))
+        offset |= 0xFC000000;
+
+    if (BIT(inst, 24))
+        MOV(32, MREG(14), Imm32(pc + 4));
+    MOV(32, R(EAX), Imm32(pc + 8 + offset));
+    Compile_SetPCAndExit(EAX);
+    return true;
+}
+
+bool ARM_JitEmitter::Compile_BranchExchange(u32 inst, u32 pc)
+{
+    u32 rm = BITS(inst, 0, 3);
+    bool link = BIT(inst, 5) != 0;
+
+    // BLX LR is left to the interpreter, it reads the target after setting LR
+    if (rm == 15 || (link && rm == 14))
+        return false;
+
+    MOV(32, R(EAX), MREG(rm));
+    if (link)
+        MOV(32, MREG(14), Imm32(pc + 4));
+    Compile_InterworkAndExit(EAX);
+    return true;
+}
+
+#endif // ARCHITECTURE_x86_64
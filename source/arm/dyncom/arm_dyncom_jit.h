@@ -0,0 +1,66 @@
+// Copyright 2015 XDS/3dmoo team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "arm/skyeye_common/armdefs.h"
+
+// runtime switch, the interpreter is used for everything when this is false
+extern bool dyncomjit;
+// log the block lookup counters of every process from time to time
+extern bool dyncomstats;
+
+#ifdef ARCHITECTURE_x86_64
+
+// the emitter is kept out of this header, its mnemonics collide with the skyeye macros
+class ARM_JitEmitter;
+
+/**
+ * Translates ARM basic blocks into x86_64 code. Only a common subset of the ARM instruction set is
+ * compiled, a block ends right before the first instruction that is not supported and the
+ * interpreter continues from there. Thumb code is never compiled.
+ */
+class ARM_Jit {
+public:
+    /// Runs a block and returns the number of guest instructions that were executed
+    typedef u32 (*JitBlock)(ARMul_State* cpu);
+
+    ARM_Jit();
+    ~ARM_Jit();
+
+    /**
+     * Get the compiled block starting at addr, compiling it on first use
+     * @param cpu ARM state the block will run on
+     * @param addr Guest address of the first instruction
+     * @param max_instrs Number of instructions the caller is still allowed to run
+     * @return The block or nullptr if the interpreter has to handle this address
+     */
+    JitBlock GetBlock(ARMul_State* cpu, u32 addr, u32 max_instrs);
+
+    /// Drops all compiled blocks
+    void Clear();
+
+    /// Drops the blocks starting in the page containing addr, the code itself stays until the next Clear
+    void InvalidatePage(u32 addr);
+
+    const BlockTableStats& GetStats() const;
+
+private:
+    struct BlockEntry {
+        JitBlock code;
+        u32 num_instrs;
+
+        bool operator==(const BlockEntry& other) const {
+            return code == other.code && num_instrs == other.num_instrs;
+        }
+    };
+
+    /// Value of addresses that were never looked up
+    static const BlockEntry s_no_entry;
+
+    BlockTable<BlockEntry> m_blocks;
+    ARM_JitEmitter* m_emitter;
+};
+
+#endif // ARCHITECTURE_x86_64
@@ -123,7 +123,7 @@ ARMword ARMul_ReLoadInstr(ARMul_State * state, ARMword address, ARMword isize) {
     return data;
 }
 
-ARMword ARMul_ReadWord(ARMul_State * state, ARMword address) {
+ARMword ARMul_ReadWordSlow(ARMul_State * state, ARMword address) {
     u32 data;
     if (unlikely(state->m_MemoryMap->Read32(address, data) != Success))
     {
@@ -132,18 +132,7 @@ ARMword ARMul_ReadWord(ARMul_State * state, ARMword address) {
     return data;
 }
 
-ARMword ARMul_LoadWordS(ARMul_State * state, ARMword address) {
-    state->NumScycles++;
-    return ARMul_ReadWord(state, address);
-}
-
-ARMword ARMul_LoadWordN(ARMul_State * state, ARMword address) {
-    state->NumNcycles++;
-    return ARMul_ReadWord(state, address);
-}
-
-ARMword ARMul_LoadHalfWord(ARMul_State * state, ARMword address) {
-    state->NumNcycles++;
+ARMword ARMul_ReadHalfWordSlow(ARMul_State * state, ARMword address) {
     u16 data;
     if (unlikely(state->m_MemoryMap->Read16(address, data) != Success))
     {
@@ -152,7 +141,7 @@ ARMword ARMul_LoadHalfWord(ARMul_State * state, ARMword address) {
     return data;
 }
 
-ARMword ARMul_ReadByte(ARMul_State * state, ARMword address) {
+ARMword ARMul_ReadByteSlow(ARMul_State * state, ARMword address) {
     u8 data;
     if (unlikely(state->m_MemoryMap->Read8(address, data) != Success))
     {
@@ -162,24 +151,13 @@ ARMword ARMul_ReadByte(ARMul_State * state, ARMword address) {
     return data;
 }
 
-ARMword ARMul_LoadByte(ARMul_State * state, ARMword address) {
-    state->NumNcycles++;
-    return ARMul_ReadByte(state, address);
-}
-
-void ARMul_StoreHalfWord(ARMul_State * state, ARMword address, ARMword data) {
-    state->NumNcycles++;
+void ARMul_WriteHalfWordSlow(ARMul_State * state, ARMword address, ARMword data) {
     if (unlikely(state->m_MemoryMap->Write16(address, data) != Success))
     {
 		XDSERROR("error %s thread %u writing %04x to %08x", state->m_currentThread->m_owner->GetName(), state->m_currentThread->m_thread_id, data, address);
     }
 }
 
-void ARMul_StoreByte(ARMul_State * state, ARMword address, ARMword data) {
-    state->NumNcycles++;
-    ARMul_WriteByte(state, address, data);
-}
-
 ARMword ARMul_SwapWord(ARMul_State * state, ARMword address, ARMword data) {
     ARMword temp;
     state->NumNcycles++;
@@ -202,14 +180,14 @@ ARMword ARMul_SwapByte(ARMul_State * state, ARMword address, ARMword data) {
     return temp;
 }
 
-void ARMul_WriteWord(ARMul_State * state, ARMword address, ARMword data) {
+void ARMul_WriteWordSlow(ARMul_State * state, ARMword address, ARMword data) {
     if (unlikely(state->m_MemoryMap->Write32(address, data) != Success))
     {
         XDSERROR("error writing to %08x data %08x", address,data);
     }
 }
 
-void ARMul_WriteByte(ARMul_State * state, ARMword address, ARMword data)
+void ARMul_WriteByteSlow(ARMul_State * state, ARMword address, ARMword data)
 {
     if (unlikely(state->m_MemoryMap->Write8(address, data) != Success))
     {
@@ -221,15 +199,3 @@ void ARMul_WriteDouble(ARMul_State* state, ARMword address, u64 data) {
     ARMul_WriteWord(state, address + 4, (u32)(data >> 32));
 }
 
-
-void ARMul_StoreWordS(ARMul_State * state, ARMword address, ARMword data)
-{
-    state->NumScycles++;
-    ARMul_WriteWord(state, address, data);
-}
-
-void ARMul_StoreWordN(ARMul_State * state, ARMword address, ARMword data)
-{
-    state->NumNcycles++;
-    ARMul_WriteWord(state, address, data);
-}
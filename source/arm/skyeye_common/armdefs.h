@@ -28,6 +28,9 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "arm/dyncom/arm_dyncom_arena.h"
+#include "arm/dyncom/arm_dyncom_blocktable.h"
+
 #include "arm_regformat.h"
 #include "Common.h"
 #include "arm/skyeye_common/armmmu.h"
@@ -158,7 +161,9 @@ typedef struct
 } mem_config_t;
 #endif
 #define VFP_REG_NUM 64
-#define bb_map std::unordered_map<u32, int>
+#define bb_map BlockTable<int>
+
+class ARM_Jit;
 
 struct ARMul_State
 {
@@ -216,6 +221,7 @@ struct ARMul_State
     unsigned int NumScycles, NumNcycles, NumIcycles, NumCcycles, NumFcycles;    /* emulated cycles used */
     unsigned long long NumInstrs;    /* the number of instructions executed */
     unsigned NumInstrsToExecute;
+    unsigned SwiInstrs;    /* instructions this run executed before the SVC that is handled */
 
     ARMword currentexaddr;
     ARMword currentexval;
@@ -399,10 +405,9 @@ So, if lateabtSig=1, then it means Late Abort Model(Base Updated Abort Model)
     KThread * m_currentThread;
 
     //ichfly fixes
-    char *inst_buf;
-    int inst_bufftop;
-    int inst_buffsize;
+    CreamArena *inst_arena;
     bb_map *CreamCache;
+    ARM_Jit *m_jit;
 };
 #define DIFF_WRITE 0
 
@@ -596,28 +601,100 @@ extern ARMword ARMul_ReLoadInstr(ARMul_State* state, ARMword address, ARMword is
 #ifdef __cplusplus
     }
 #endif
-extern ARMword ARMul_LoadWordS(ARMul_State* state, ARMword address);
-extern ARMword ARMul_LoadWordN(ARMul_State* state, ARMword address);
-extern ARMword ARMul_LoadHalfWord(ARMul_State* state, ARMword address);
-extern ARMword ARMul_LoadByte(ARMul_State* state, ARMword address);
-
-extern void ARMul_StoreWordS(ARMul_State* state, ARMword address, ARMword data);
-extern void ARMul_StoreWordN(ARMul_State* state, ARMword address, ARMword data);
-extern void ARMul_StoreHalfWord(ARMul_State* state, ARMword address, ARMword data);
-extern void ARMul_StoreByte(ARMul_State* state, ARMword address, ARMword data);
-
 extern ARMword ARMul_SwapWord(ARMul_State* state, ARMword address, ARMword data);
 extern ARMword ARMul_SwapByte(ARMul_State* state, ARMword address, ARMword data);
 
 extern void ARMul_Icycles(ARMul_State* state, unsigned number, ARMword address);
 extern void ARMul_Ccycles(ARMul_State* state, unsigned number, ARMword address);
 
-extern ARMword ARMul_ReadWord(ARMul_State* state, ARMword address);
-extern ARMword ARMul_ReadByte(ARMul_State* state, ARMword address);
-extern void ARMul_WriteWord(ARMul_State* state, ARMword address, ARMword data);
-extern void ARMul_WriteByte(ARMul_State* state, ARMword address, ARMword data);
 extern void ARMul_WriteDouble(ARMul_State* state, ARMword address, u64 data);
 
+/* IO, unmapped memory, faults and accesses that cross a page go through KMemoryMap */
+extern ARMword ARMul_ReadWordSlow(ARMul_State* state, ARMword address);
+extern ARMword ARMul_ReadHalfWordSlow(ARMul_State* state, ARMword address);
+extern ARMword ARMul_ReadByteSlow(ARMul_State* state, ARMword address);
+extern void ARMul_WriteWordSlow(ARMul_State* state, ARMword address, ARMword data);
+extern void ARMul_WriteHalfWordSlow(ARMul_State* state, ARMword address, ARMword data);
+extern void ARMul_WriteByteSlow(ARMul_State* state, ARMword address, ARMword data);
+
+/* Plain memory is accessed straight through the host pointer of its page */
+inline ARMword ARMul_ReadWord(ARMul_State* state, ARMword address) {
+    u8* page = state->m_MemoryMap->GetReadPage(address);
+    if (likely(page && (address & PAGE_MASK) <= PAGE_SIZE - 4))
+        return *(u32*)&page[address & PAGE_MASK];
+    return ARMul_ReadWordSlow(state, address);
+}
+
+inline ARMword ARMul_ReadByte(ARMul_State* state, ARMword address) {
+    u8* page = state->m_MemoryMap->GetReadPage(address);
+    if (likely(page))
+        return page[address & PAGE_MASK];
+    return ARMul_ReadByteSlow(state, address);
+}
+
+inline void ARMul_WriteWord(ARMul_State* state, ARMword address, ARMword data) {
+    u8* page = state->m_MemoryMap->GetWritePage(address);
+    if (likely(page && (address & PAGE_MASK) <= PAGE_SIZE - 4))
+        *(u32*)&page[address & PAGE_MASK] = data;
+    else
+        ARMul_WriteWordSlow(state, address, data);
+}
+
+inline void ARMul_WriteByte(ARMul_State* state, ARMword address, ARMword data) {
+    u8* page = state->m_MemoryMap->GetWritePage(address);
+    if (likely(page))
+        page[address & PAGE_MASK] = (u8)data;
+    else
+        ARMul_WriteByteSlow(state, address, data);
+}
+
+inline ARMword ARMul_LoadWordS(ARMul_State* state, ARMword address) {
+    state->NumScycles++;
+    return ARMul_ReadWord(state, address);
+}
+
+inline ARMword ARMul_LoadWordN(ARMul_State* state, ARMword address) {
+    state->NumNcycles++;
+    return ARMul_ReadWord(state, address);
+}
+
+inline ARMword ARMul_LoadHalfWord(ARMul_State* state, ARMword address) {
+    state->NumNcycles++;
+    u8* page = state->m_MemoryMap->GetReadPage(address);
+    if (likely(page && (address & PAGE_MASK) <= PAGE_SIZE - 2))
+        return *(u16*)&page[address & PAGE_MASK];
+    return ARMul_ReadHalfWordSlow(state, address);
+}
+
+inline ARMword ARMul_LoadByte(ARMul_State* state, ARMword address) {
+    state->NumNcycles++;
+    return ARMul_ReadByte(state, address);
+}
+
+inline void ARMul_StoreWordS(ARMul_State* state, ARMword address, ARMword data) {
+    state->NumScycles++;
+    ARMul_WriteWord(state, address, data);
+}
+
+inline void ARMul_StoreWordN(ARMul_State* state, ARMword address, ARMword data) {
+    state->NumNcycles++;
+    ARMul_WriteWord(state, address, data);
+}
+
+inline void ARMul_StoreHalfWord(ARMul_State* state, ARMword address, ARMword data) {
+    state->NumNcycles++;
+    u8* page = state->m_MemoryMap->GetWritePage(address);
+    if (likely(page && (address & PAGE_MASK) <= PAGE_SIZE - 2))
+        *(u16*)&page[address & PAGE_MASK] = (u16)data;
+    else
+        ARMul_WriteHalfWordSlow(state, address, data);
+}
+
+inline void ARMul_StoreByte(ARMul_State* state, ARMword address, ARMword data) {
+    state->NumNcycles++;
+    ARMul_WriteByte(state, address, data);
+}
+
 extern ARMword ARMul_MemAccess(ARMul_State* state, ARMword, ARMword,
                 ARMword, ARMword, ARMword, ARMword, ARMword,
                 ARMword, ARMword, ARMword);
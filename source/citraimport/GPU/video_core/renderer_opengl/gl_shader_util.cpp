@@ -5,7 +5,7 @@
 #include <algorithm>
 #include <vector>
 
-#include "Log.h"
+#include "Common.h"
 
 #include "citraimport/GPU/video_core/renderer_opengl/gl_shader_util.h"
 
@@ -13,6 +13,8 @@
 #include "citraimport/common/logging/log.h"
 #include "citraimport/common/logging/text_formatter.h"
 
+#include "Log.h"
+
 namespace Log {
 
 /// Macro listing all log classes. Code should define CLS and SUB as desired before invoking this.
@@ -121,6 +123,10 @@ void SetFilter(Filter* new_filter) {
 void LogMessage(Class log_class, Level log_level,
                 const char* filename, unsigned int line_nr, const char* function,
                 const char* format, ...) {
+    // Citra's levels line up with ours up to Error, Critical is logged as an error
+    int level = log_level < Level::Critical ? (int)log_level : LOGLEVEL_ERROR;
+    if (level < log_levels[LOGCLASS_CITRA])
+        return;
     if (filter != nullptr && !filter->CheckMessage(log_class, log_level))
         return;
 
@@ -130,7 +136,10 @@ void LogMessage(Class log_class, Level log_level,
             filename, line_nr, function, format, args);
     va_end(args);
 
-    PrintColoredMessage(entry);
+    // goes through the XDS logger so the messages stay in order with LOG
+    std::array<char, 4 * 1024> format_buffer;
+    FormatLogMessage(entry, format_buffer.data(), format_buffer.size());
+    LogWrite(LOGCLASS_CITRA, level, "%s", format_buffer.data());
 }
 
 }
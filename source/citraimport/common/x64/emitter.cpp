@@ -27,6 +27,15 @@
 #include "cpu_detect.h"
 #include "emitter.h"
 
+// the asserts here carry a message, MSVC drops the extra arguments but GCC does not take them
+#undef assert
+#ifdef NDEBUG
+#define assert(...) ((void)0)
+#else
+#define EMITTER_ASSERT_CONDITION(_a_, ...) (_a_)
+#define assert(...) ASSERT(EMITTER_ASSERT_CONDITION(__VA_ARGS__, ""))
+#endif
+
 namespace Gen
 {
 
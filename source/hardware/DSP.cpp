@@ -1,3 +1,5 @@
+#define LOG_CLASS LOGCLASS_DSP
+
 #include "Kernel.h"
 #include "Hardware.h"
 
@@ -18,7 +20,7 @@ u8 DSP::Read8(u32 addr)
 u16 DSP::Read16(u32 addr)
 {
 	u16 temp;
-	LOG("DSP u16 read from %08x", addr);
+	LOGTRACE("DSP u16 read from %08x", addr);
 	switch (addr & 0xFFF)
 	{
 	case 0:
@@ -78,7 +80,7 @@ void DSP::Write8(u32 addr, u8 data)
 }
 void DSP::Write16(u32 addr, u16 data)
 {
-	LOG("DSP write %04x to %08x", data, addr);
+	LOGTRACE("DSP write %04x to %08x", data, addr);
 	switch (addr & 0xFFF)
 	{
 	case 0:
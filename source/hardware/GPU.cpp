@@ -1,3 +1,5 @@
+#define LOG_CLASS LOGCLASS_GPU
+
 #include "Kernel.h"
 #include "Hardware.h"
 
@@ -43,7 +45,7 @@ u16 GPUHW::Read16(u32 addr)
 u32 GPUHW::Read32(u32 addr)
 {
 	u32 data;
-	LOG("GPUHW unknown u32 read from %08x", addr);
+	LOGTRACE("GPUHW u32 read from %08x", addr);
 	GPU::Read<u32>(data, addr);
 	return data;
 	/*switch (addr & 0x1FFFF)
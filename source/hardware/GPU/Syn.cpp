@@ -5,18 +5,11 @@ extern "C" void VBlankCallback();
 
 Syncer::Syncer(GPUHW *owner, bool bottom) : m_owner(owner), m_bottom(bottom)
 {
-	m_owner->m_kernel->m_Timedevent.AddItem(this);
 	m_owner->m_kernel->FireNextTimeEvent(this, 4468724); //60 times per sec
 }
 Syncer::~Syncer()
 {
-	KLinkedListNode<KTimeedEvent> *t = m_owner->m_kernel->m_Timedevent.list;
-	while (t)
-	{
-		if (t->data == this)
-			m_owner->m_kernel->m_Timedevent.RemoveItem(t);
-		t = t->next;
-	}
+	m_owner->m_kernel->CancelTimeEvent(this);
 }
 void Syncer::trigger_event()
 {
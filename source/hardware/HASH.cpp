@@ -1,34 +1,6 @@
 #include "Kernel.h"
 #include "Hardware.h"
 
-static const unsigned int sha256_k[64] = //UL = uint32
-{ 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
-
-
-#define SHA2_SHFR(x, n)    (x >> n)
-#define SHA2_ROTR(x, n)   ((x >> n) | (x << ((sizeof(x) << 3) - n)))
-#define SHA2_ROTL(x, n)   ((x << n) | (x >> ((sizeof(x) << 3) - n)))
-#define SHA2_CH(x, y, z)  ((x & y) ^ (~x & z))
-#define SHA2_MAJ(x, y, z) ((x & y) ^ (x & z) ^ (y & z))
-#define SHA256_F1(x) (SHA2_ROTR(x,  2) ^ SHA2_ROTR(x, 13) ^ SHA2_ROTR(x, 22))
-#define SHA256_F2(x) (SHA2_ROTR(x,  6) ^ SHA2_ROTR(x, 11) ^ SHA2_ROTR(x, 25))
-#define SHA256_F3(x) (SHA2_ROTR(x,  7) ^ SHA2_ROTR(x, 18) ^ SHA2_SHFR(x,  3))
-#define SHA256_F4(x) (SHA2_ROTR(x, 17) ^ SHA2_ROTR(x, 19) ^ SHA2_SHFR(x, 10))
 #define SHA2_UNPACK32(x, str)                 \
 {                                             \
     *((str) + 3) = (u8) ((x)      );       \
@@ -36,14 +8,6 @@ static const unsigned int sha256_k[64] = //UL = uint32
     *((str) + 1) = (u8) ((x) >> 16);       \
     *((str) + 0) = (u8) ((x) >> 24);       \
 }
-#define SHA2_PACK32(str, x)                   \
-{                                             \
-    *(x) =   ((u32) *((str) + 3)      )    \
-           | ((u32) *((str) + 2) <<  8)    \
-           | ((u32) *((str) + 1) << 16)    \
-           | ((u32) *((str) + 0) << 24);   \
-}
-
 
 HWHASH::HWHASH(KKernel * kernel) : m_kernel(kernel), HASH_CNT(0)
 {
@@ -179,40 +143,7 @@ void HWHASH::finalise()
 }
 void HWHASH::transform(const u8 *message, u32 block_nb)
 {
-	u32 w[64];
-	u32 wv[8];
-	u32 t1, t2;
-	const unsigned char *sub_block;
-	int i;
-	int j;
-	for (i = 0; i < (int)block_nb; i++) {
-		sub_block = message + (i << 6);
-		for (j = 0; j < 16; j++) {
-			SHA2_PACK32(&sub_block[j << 2], &w[j]);
-		}
-		for (j = 16; j < 64; j++) {
-			w[j] = SHA256_F4(w[j - 2]) + w[j - 7] + SHA256_F3(w[j - 15]) + w[j - 16];
-		}
-		for (j = 0; j < 8; j++) {
-			wv[j] = m_h[j];
-		}
-		for (j = 0; j < 64; j++) {
-			t1 = wv[7] + SHA256_F2(wv[4]) + SHA2_CH(wv[4], wv[5], wv[6])
-				+ sha256_k[j] + w[j];
-			t2 = SHA256_F1(wv[0]) + SHA2_MAJ(wv[0], wv[1], wv[2]);
-			wv[7] = wv[6];
-			wv[6] = wv[5];
-			wv[5] = wv[4];
-			wv[4] = wv[3] + t1;
-			wv[3] = wv[2];
-			wv[2] = wv[1];
-			wv[1] = wv[0];
-			wv[0] = t1 + t2;
-		}
-		for (j = 0; j < 8; j++) {
-			m_h[j] += wv[j];
-		}
-	}
+	Common::Sha256Transform(m_h, message, block_nb);
 }
 void HWHASH::update(const u8 *message, u32 len)
 {
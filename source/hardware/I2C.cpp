@@ -1,3 +1,5 @@
+#define LOG_CLASS LOGCLASS_HW
+
 #include "Kernel.h"
 #include "Hardware.h"
 
@@ -76,9 +78,7 @@ void IOI2C::Write8(u32 addr, u8 data)
 			if (!(data & 0x20))
 			{
 				LOG("I2C write (%02x) (%08x) end", m_deviceID, m_index); //this is of by one when the direction swap
-				for (int i = 0; i < m_index; i++)
-					printf("%02x ", m_buffer[i]);
-				LOG("");
+				LOGHEX(m_buffer, m_index);
 			}
 		}
 		if (data & 0x2) //Start
@@ -94,9 +94,7 @@ void IOI2C::Write8(u32 addr, u8 data)
 			else
 			{
 				LOG("I2C write (%02x) (%08x)", m_deviceID, m_index); //this is of by one when the direction swap
-				for (int i = 0; i < m_index; i++)
-					printf("%02x ", m_buffer[i]);
-				LOG("");
+				LOGHEX(m_buffer, m_index);
 			}
 			m_index = 0;
 		}
@@ -16,33 +16,31 @@ bool KAddressArbiter::IsInstanceOf(ClassName name) {
 
     return super::IsInstanceOf(name);
 }
-static KLinkedListNode<KThread>* threads_ArbitrateHighestPrioThread(KLinkedList<KThread> *list, u32 addr) //this also removes
+static KThread* threads_ArbitrateHighestPrioThread(KThread* first, u32 addr)
 {
-    KLinkedListNode<KThread> *ret = NULL;
+    KThread *ret = NULL;
     s32 highest_prio = 0x80;
-    KLinkedListNode<KThread>* node = list->list;
-    while (node) {
-        if (node->data->arb_addr == addr) {
-            if (node->data->m_thread_prio <= highest_prio) {
-                ret = node;
-                highest_prio = node->data->m_thread_prio;
+    for (KThread* thread = first; thread; thread = thread->m_arbiter_link.next) {
+        if (thread->arb_addr == addr) {
+            if (thread->m_thread_prio <= highest_prio) {
+                ret = thread;
+                highest_prio = thread->m_thread_prio;
             }
         }
-        node = node->next;
     }
 
     return ret;
 }
 Result KAddressArbiter::ArbitrateAddress(u32 addr,u32 type, s32 val, s64 time, KThread * caller)
 {
-    KLinkedListNode<KThread>* p;
+    KThread* p;
     switch (type) {
         case 0: // Free
         // Negative value means resume all threads
             if (val < 0) {
-                while (p = threads_ArbitrateHighestPrioThread(&arbiterlist, addr))
+                while (p = threads_ArbitrateHighestPrioThread(arbiterlist.list, addr))
                 {
-                    m_owner->m_Kernel->StartThread(p->data);
+                    m_owner->m_Kernel->StartThread(p);
                     arbiterlist.RemoveItem(p);
                 }
         return 0;
@@ -50,9 +48,9 @@ Result KAddressArbiter::ArbitrateAddress(u32 addr,u32 type, s32 val, s64 time, K
 
         // Resume first N threads
         for (int i = 0; i<val; i++) {
-            if (p = threads_ArbitrateHighestPrioThread(&arbiterlist, addr))
+            if (p = threads_ArbitrateHighestPrioThread(arbiterlist.list, addr))
             {
-                m_owner->m_Kernel->StartThread(p->data);
+                m_owner->m_Kernel->StartThread(p);
                 arbiterlist.RemoveItem(p);
             }
         else break;
@@ -1,4 +1,6 @@
 #include "Kernel.h"
+#include "Hardware.h"
+#include "Process9.h"
 
 //tools
 
@@ -8,12 +10,23 @@ void KClientSession::Destroy() {
 }
 bool KClientSession::Synchronization(KThread* thread, u32 &error)
 {
+    // requests that pxi only passes on to Process9 skip the server and the FIFO
+    Process9* p9 = thread->m_owner->m_Kernel->m_p9;
+    if (m_owner->m_p9_channel >= 0 && p9->IsHLE() && p9->HLERequest(m_owner->m_p9_channel, thread))
+        return false;
+
     KThread * tnew = m_owner->m_Server.SynGetNextPrio();
     if (tnew && !m_owner->m_Server.m_processingCmd)
     {
+        s32 ret = m_owner->Communicate(thread,tnew , false);
+        if (ret != Success)
+        {
+            // the server keeps waiting, the client gets the error right away
+            error = ret;
+            return false;
+        }
         m_owner->m_Server.m_waitingForCmdResp = thread;
         m_owner->m_Server.m_processingCmd = tnew;
-        m_owner->Communicate(thread,tnew , false);
         m_owner->m_Server.SynFree(0, tnew);
     }
     return true; //stall
@@ -2,9 +2,15 @@
 #include "Hardware.h"
 #include "Process9.h"
 
+#include <thread>
 
-KKernel::KKernel() : m_core0(this), m_core1(this), m_core2(this), m_core3(this), m_NextProcessID(0), m_NextThreadID(0), tempsh(), m_numbFirmProcess(0)
+
+KKernel::KKernel() : m_core0(this), m_core1(this), m_core2(this), m_core3(this), m_NextProcessID(0), m_NextThreadID(0), m_rounds(0), m_numbFirmProcess(0), m_cycles(0), m_num_cores(1), m_next_core(0), m_quantum(0), m_cores_waiting(0), m_quantum_cycles(0), m_realtime(false), m_realtime_cycles(0)
 {
+    m_cores[0] = &m_core0;
+    m_cores[1] = &m_core1;
+    m_cores[2] = &m_core2;
+    m_cores[3] = &m_core3;
     memset(m_FIRM_Launch_Parameters, 0, sizeof(m_FIRM_Launch_Parameters));
     for (int i = 0; i < sizeof(m_Interrupt) / sizeof(KLinkedList<KInterrupt>*); i++)
         m_Interrupt[i] = new KLinkedList<KInterrupt>();
@@ -25,10 +31,52 @@ KKernel::KKernel() : m_core0(this), m_core1(this), m_core2(this), m_core3(this),
 	m_MIC = new MIC(this);
 }
 
+// core the calling host thread runs
+static THREAD_LOCAL KArmCore* t_core = NULL;
+
+void KKernel::SetCoreCount(s32 count)
+{
+    m_num_cores = count < 1 ? 1 : (count > MAX_CORES ? MAX_CORES : count);
+}
+u32 KKernel::GetCoreCount()
+{
+    return m_num_cores;
+}
+void KKernel::SetRealTime(bool realtime)
+{
+    m_realtime = realtime;
+}
+void KKernel::SetCyclesPerInstruction(double cpi)
+{
+    double steps = cpi * 256 + 0.5;
+    u32 fixed = steps < 1 ? 1 : (steps > 256 * 256 ? 256 * 256 : (u32)steps);
+    for (u32 i = 0; i < MAX_CORES; i++)
+        m_cores[i]->SetCyclesPerInstruction(fixed);
+}
+u64 KKernel::GetSystemTick()
+{
+    if (t_core && t_core->InSlice())
+        return t_core->GetClock();
+    return m_cycles;
+}
+KThread* KKernel::GetCurrentThread()
+{
+    return t_core ? t_core->GetThread() : NULL;
+}
+u64 KKernel::NanosecondsToTicks(s64 nanoseconds)
+{
+    if (nanoseconds <= 0)
+        return 0;
+    u64 ns = nanoseconds;
+    // split so the product can not overflow
+    return ns / 1000000000 * ARM11_CLOCK_RATE + ns % 1000000000 * ARM11_CLOCK_RATE / 1000000000;
+}
 void KKernel::AddProcess(KProcess* p, bool is_firm_process)
 {
     if (is_firm_process)
         m_numbFirmProcess++;
+    p->m_host_core = m_next_core;
+    m_next_core = (m_next_core + 1) % m_num_cores;
     m_processes.AddItem(p);
 }
 
@@ -40,115 +88,223 @@ void KKernel::AddQuickCodeProcess(u8* buf, size_t size) {
 }
 void KKernel::StartThread(KThread* p)
 {
-    tempsh.AddItem(p);
+    p->m_started = true;
+    UpdateReadyState(p);
 }
 void KKernel::ReScheduler()
 {
-    m_core0.ReSchedule();
+    if (t_core)
+        t_core->ReSchedule();
 }
 void KKernel::StopThread(KThread* p)
 {
-    KLinkedListNode<KThread> *temp = tempsh.list;
-    while (temp)
-    {
-        if (temp->data == p)
-            break;
-        temp = temp->next;
-        if (!temp->next)
-            break;
-    }
-    if (temp)
-        tempsh.RemoveItem(temp);
+    p->m_started = false;
+    UpdateReadyState(p);
+}
+void KKernel::UpdateReadyState(KThread* p)
+{
+    bool ready = p->m_started && p->m_running && p->m_wait_left == 0;
+    if (ready == p->m_ready)
+        return;
+    p->m_ready = ready;
+    KScheduler& scheduler = m_scheduler[p->m_owner->m_host_core];
+    if (ready)
+        scheduler.AddToScheduler(p);
+    else
+        scheduler.RemoveFromScheduler(p);
+}
+void KKernel::SetThreadPriority(KThread* p, s32 prio)
+{
+    KScheduler& scheduler = m_scheduler[p->m_owner->m_host_core];
+    if (p->m_ready)
+        scheduler.RemoveFromScheduler(p);
+    p->m_thread_prio = prio;
+    if (p->m_ready)
+        scheduler.AddToScheduler(p);
+}
+u64 KKernel::NextEventCycles(u64 max)
+{
+	u64 next = m_Timedevent.NextDeadline();
+	u64 left = next > m_cycles ? next - m_cycles : 0;
+	return (left < max ? left : max) + 1;
+}
+void KKernel::RunTimedEvents()
+{
+	KTimeedEvent* eve;
+	while ((eve = m_Timedevent.PopDue(m_cycles)) != NULL)
+		eve->trigger_event();
 }
-u64 KKernel::FindTimedEventWithSmallestCyclesRemaining()
+bool KKernel::AllThreadsWaiting()
 {
-	int min = 1000;
-	KLinkedListNode<KTimeedEvent> *t = m_Timedevent.list;
-	while (t)
+	for (u32 i = 0; i < m_num_cores; i++)
 	{
-		if (t->data->num_cycles_remaining != 0)
-		{
-			min = min > t->data->num_cycles_remaining ? t->data->num_cycles_remaining : min;
-		}
-		t = t->next;
+		if (m_scheduler[i].FirstThread(PRIO_HIGH))
+			return false;
 	}
-	return min + 1;
+	return true;
+}
+bool KKernel::SkipIdle()
+{
+	u64 next = m_Timedevent.NextDeadline();
+	if (next == ~(u64)0)
+		return false;
+	if (next > m_cycles)
+		m_cycles = next;
+	return true;
+}
+std::chrono::steady_clock::time_point KKernel::RealTimeAt(u64 cycles)
+{
+	std::chrono::duration<double> ahead((cycles - m_realtime_cycles) / (double)ARM11_CLOCK_RATE);
+	return m_realtime_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(ahead);
 }
 
 extern "C" void citraFireInterrupt(int id);
 
 void KKernel::ThreadsRunTemp()
 {
-	KLinkedListNode<KThread> *temp = tempsh.list;
+	if (m_num_cores > 1)
+	{
+		RunCores();
+		return;
+	}
+
+	KScheduler& scheduler = m_scheduler[0];
+	t_core = &m_core0;
+	m_realtime_start = std::chrono::steady_clock::now();
+	m_realtime_cycles = m_cycles;
+	scheduler.StartRound();
 	while (true)
 	{
-		KThread * current = temp->data;
-		if (current->m_running)
+		// only threads that can run are queued, they come in priority order
+		KThread * current = scheduler.NextInRound();
+		if (current)
 		{
 			m_core0.SetThread(current);
-			if (!current->Threadwaitlist || !current->Threadwaitlist->list)
-			{
-				current->m_core = &m_core0;
-
-				u64 min_cycles = FindTimedEventWithSmallestCyclesRemaining();
-				u64 cycles_run = m_core0.RunCycles((uint)min_cycles);
-				KLinkedListNode<KTimeedEvent> *t = m_Timedevent.list;
-				while (t)
-				{
-					if (t->data->num_cycles_remaining != 0)
-					{
-						t->data->num_cycles_remaining -= cycles_run;
-						if (t->data->num_cycles_remaining <= 0)
-						{
-							t->data->num_cycles_remaining = 0;
-							t->data->trigger_event();
-						}
-					}
-					t = t->next;
-				}
-
-
-				current->m_core = NULL;
-			}
+			current->m_core = &m_core0;
+			current->m_owner->RunPendingInvalidations();
+
+			u64 min_cycles = NextEventCycles(MAX_SLICE_CYCLES);
+			u64 cycles_run = m_core0.RunCycles(min_cycles, m_cycles);
+			m_core0.ReleaseThread();
+			current->m_core = NULL;
+
+			m_cycles += cycles_run;
+			RunTimedEvents();
+			continue;
 		}
-		else
+
+		if (dyncomstats && (++m_rounds & 0xFFFF) == 0)
+			DumpDyncomStats();
+
+		if (AllThreadsWaiting() && SkipIdle())
 		{
-			StopThread(current);
+			if (m_realtime)
+				std::this_thread::sleep_until(RealTimeAt(m_cycles));
+			RunTimedEvents();
+			scheduler.StartRound();
+			continue;
 		}
-		if (!temp->next)
-		{
-			temp = tempsh.list;
 
 		//fallback todo increas cycels
-		u64 min_cycles = FindTimedEventWithSmallestCyclesRemaining();
+		u64 min_cycles = NextEventCycles(MAX_SLICE_CYCLES);
+		m_cycles += min_cycles;
+		RunTimedEvents();
 
-		m_core0.Addticks(min_cycles);
-		m_core1.Addticks(min_cycles);
-		m_core2.Addticks(min_cycles);
-		m_core3.Addticks(min_cycles);
-
-		KLinkedListNode<KTimeedEvent> *t = m_Timedevent.list;
-		while (t)
+		scheduler.StartRound();
+	}
+}
+void KKernel::RunCores()
+{
+	m_quantum_cycles = NextEventCycles(MAX_QUANTUM_CYCLES);
+	m_realtime_start = std::chrono::steady_clock::now();
+	m_realtime_cycles = m_cycles;
+	for (u32 i = 1; i < m_num_cores; i++)
+		std::thread(&KKernel::RunCore, this, i).detach();
+	// the timed events draw, so they stay on the main thread with core 0
+	RunCore(0);
+}
+void KKernel::RunCore(u32 id)
+{
+	KArmCore* core = m_cores[id];
+	KScheduler& scheduler = m_scheduler[id];
+	t_core = core;
+	while (true)
+	{
+		// the threads run round robin till the quantum is used up, the kernel is only locked between slices
+		u64 quantum = m_quantum_cycles;
+		u64 ran = 0;
+		bool any = false;
+		m_lock.lock();
+		scheduler.StartRound();
+		while (ran < quantum)
 		{
-			if (t->data->num_cycles_remaining != 0)
+			KThread * current = scheduler.NextInRound();
+			if (!current)
 			{
-				t->data->num_cycles_remaining -= min_cycles;
-				if (t->data->num_cycles_remaining <= 0)
-				{
-					t->data->num_cycles_remaining = 0;
-					t->data->trigger_event();
-				}
+				// nothing ran this round, the core idles till the others are done
+				if (!any)
+					break;
+				any = false;
+				scheduler.StartRound();
+				continue;
 			}
-			t = t->next;
-		}
+			any = true;
+			core->SetThread(current);
+			current->m_core = core;
+			m_lock.unlock();
+			current->m_owner->RunPendingInvalidations();
 
-		}
-		else
-			temp = temp->next;
+			u64 slice = quantum - ran < MAX_SLICE_CYCLES ? quantum - ran : MAX_SLICE_CYCLES;
+			ran += core->RunCycles(slice, m_cycles + ran);
 
+			m_lock.lock();
+			core->ReleaseThread();
+			current->m_core = NULL;
+		}
+		m_lock.unlock();
+		EndQuantum(id);
+	}
+}
+void KKernel::EndQuantum(u32 id)
+{
+	std::unique_lock<std::mutex> lock(m_quantum_mutex);
+	if (id != 0)
+	{
+		u32 quantum = m_quantum;
+		m_cores_waiting++;
+		m_quantum_cond.notify_all();
+		while (m_quantum == quantum)
+			m_quantum_cond.wait(lock);
+		return;
+	}
 
+	while (m_cores_waiting < m_num_cores - 1)
+		m_quantum_cond.wait(lock);
+	m_cores_waiting = 0;
 
+	m_lock.lock();
+	if (dyncomstats && (++m_rounds & 0xFFF) == 0)
+		DumpDyncomStats();
+	m_cycles += m_quantum_cycles;
+	RunTimedEvents();
+	// the other cores wait here, so nothing runs while the clock skips
+	if (AllThreadsWaiting() && SkipIdle())
+	{
+		if (m_realtime)
+		{
+			// the host threads that fire interrupts need the lock while this sleeps
+			std::chrono::steady_clock::time_point wake = RealTimeAt(m_cycles);
+			m_lock.unlock();
+			std::this_thread::sleep_until(wake);
+			m_lock.lock();
+		}
+		RunTimedEvents();
 	}
+	m_quantum_cycles = NextEventCycles(MAX_QUANTUM_CYCLES);
+	m_lock.unlock();
+
+	m_quantum++;
+	m_quantum_cond.notify_all();
 }
 u32 KKernel::GetNextThreadID()
 {
@@ -193,9 +349,39 @@ s32 KKernel::UnRegisterInterrupt(u32 name, KSynchronizationObject* syncObject)
     return -1;
 
 }
+void KKernel::DumpDyncomStats()
+{
+    KLinkedListNode<KProcess> *node = m_processes.list;
+    while (node)
+    {
+        KProcess* process = node->data;
+        const BlockTableStats& stats = process->CreamCache->GetStats();
+        LOG("Process %s block lookups %llu hits %llu misses %llu", process->GetName(), stats.lookups, stats.hits, stats.misses);
+        CreamArenaStats creams = process->CreamBuffer->GetStats();
+        LOG("Process %s creams %llu bytes in %u chunks recycled %llu flushes %llu", process->GetName(), creams.used, creams.chunks, creams.recycled, creams.flushes);
+#ifdef ARCHITECTURE_x86_64
+        if (process->m_jit)
+        {
+            const BlockTableStats& jit = process->m_jit->GetStats();
+            LOG("Process %s jit lookups %llu hits %llu misses %llu", process->GetName(), jit.lookups, jit.hits, jit.misses);
+        }
+#endif
+        node = node->next;
+    }
+}
 void KKernel::FireNextTimeEvent(KTimeedEvent* eve, u64 ticks)
 {
-	eve->num_cycles_remaining = ticks; //todo make more acurate
+	if (ticks == 0)
+		m_Timedevent.Cancel(eve);
+	else
+	{
+		u64 now = GetSystemTick();
+		m_Timedevent.Schedule(eve, now + ticks < now ? ~(u64)0 : now + ticks);
+	}
+}
+void KKernel::CancelTimeEvent(KTimeedEvent* eve)
+{
+	m_Timedevent.Cancel(eve);
 }
 void KKernel::FireInterrupt(u32 name)
 {
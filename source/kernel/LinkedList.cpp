@@ -0,0 +1,37 @@
+#include "Kernel.h"
+
+#define LIST_NODES_PER_BLOCK 256
+
+struct FreeListNode {
+    FreeListNode* next;
+};
+
+// every host thread has its own free nodes, so the cores never wait for each other here
+static THREAD_LOCAL FreeListNode* t_free_nodes = NULL;
+
+void* KLinkedListAllocNode()
+{
+    FreeListNode* node = t_free_nodes;
+    if (unlikely(node == NULL))
+    {
+        // the blocks are never given back, the lists stay about as long as they once were
+        u8* block = (u8*)malloc(LIST_NODE_SIZE * LIST_NODES_PER_BLOCK);
+        if (block == NULL)
+            return NULL;
+        for (u32 i = 0; i < LIST_NODES_PER_BLOCK; i++)
+        {
+            FreeListNode* free_node = (FreeListNode*)(block + i * LIST_NODE_SIZE);
+            free_node->next = node;
+            node = free_node;
+        }
+    }
+    t_free_nodes = node->next;
+    return node;
+}
+
+void KLinkedListFreeNode(void* node)
+{
+    FreeListNode* free_node = (FreeListNode*)node;
+    free_node->next = t_free_nodes;
+    t_free_nodes = free_node;
+}
@@ -2,12 +2,6 @@
 #include "Hardware.h"
 #include "Process9.h"
 
-#define LOGHIGHACCESS
-
-//#define LOGMODULE "codec"
-//#define RWLOG
-//#define WLOG
-
 #define TtoTT(x)   case x: \
 case x + 0x1000: \
 case x + 0x2000: \
@@ -42,23 +36,139 @@ TtoTT(x + 0xD0000) \
 TtoTT(x + 0xE0000) \
 TtoTT(x + 0xF0000) \
 
+const MemPage KMemoryMap::s_free_page = {};
+MemoryWatch KMemoryMap::s_watches[MAX_WATCHES];
+u32 KMemoryMap::s_num_watches = 0;
+std::vector<KMemoryMap*> KMemoryMap::s_maps;
+
 KMemoryMap::KMemoryMap(KProcess* process) {
     m_process = process;
-    memset(m_pages, 0, sizeof(m_pages));
+    memset(m_leaves, 0, sizeof(m_leaves));
     memset(m_TLSused, 0, sizeof(m_TLSused));
     memset(m_TLSpointer, 0, sizeof(m_TLSpointer));
+    m_ipc_next = IPC_VA_START / PAGE_SIZE;
+    m_fast_read = (u8**)calloc(NUM_FAST_PAGES, sizeof(u8*));
+    m_fast_write = (u8**)calloc(NUM_FAST_PAGES, sizeof(u8*));
+    if (m_fast_read == NULL || m_fast_write == NULL) {
+        XDSERROR("out of memory for the fast page tables");
+        exit(1);
+    }
+    s_maps.push_back(this);
+}
+
+KMemoryMap::~KMemoryMap() {
+    for (u32 i = 0; i < NUM_PAGES / NUM_LEAF_PAGES; i++)
+        free(m_leaves[i]);
+    free(m_fast_read);
+    free(m_fast_write);
+    for (u32 i = 0; i < s_maps.size(); i++) {
+        if (s_maps[i] == this) {
+            s_maps.erase(s_maps.begin() + i);
+            break;
+        }
+    }
+}
+
+MemPage& KMemoryMap::AllocPage(u32 page) {
+    MemPage*& leaf = m_leaves[page / NUM_LEAF_PAGES];
+    if (leaf == NULL) {
+        leaf = (MemPage*)calloc(NUM_LEAF_PAGES, sizeof(MemPage));
+        if (leaf == NULL) {
+            XDSERROR("out of memory for the page table");
+            exit(1);
+        }
+    }
+    return leaf[page % NUM_LEAF_PAGES];
+}
+
+// bytes from addr to the end of its page, at most size
+static u32 PageChunk(u32 addr, u32 size) {
+    u32 left = PAGE_SIZE - (addr & PAGE_MASK);
+    return size < left ? size : left;
 }
 
 Result KMemoryMap::ReadN(u32 addr, u8* out, u32 size) {
+    while (size) {
+        u32 len = PageChunk(addr, size);
+        u8* page = GetReadPage(addr);
+
+        if (likely(page)) {
+            memcpy(out, page + (addr & PAGE_MASK), len);
+        } else {
+            for (u32 i = 0; i < len; i++) {
+                if (Read8(addr + i, out[i]) != Success)
+                    return -1;
+            }
+        }
+        addr += len;
+        out += len;
+        size -= len;
+    }
+    return Success;
+}
 
-	for (u32 i = 0; i < size; i++)
-	{
-		s32 res = Read8(addr + i, out[i]);
-		if (res != Success)
-			return res;
-	}
+Result KMemoryMap::WriteN(u32 addr, const u8* in, u32 size) {
+    while (size) {
+        u32 len = PageChunk(addr, size);
+        u8* page = GetWritePage(addr);
+
+        if (likely(page)) {
+            memcpy(page + (addr & PAGE_MASK), in, len);
+        } else {
+            for (u32 i = 0; i < len; i++) {
+                if (Write8(addr + i, in[i]) != Success)
+                    return -1;
+            }
+        }
+        addr += len;
+        in += len;
+        size -= len;
+    }
+    return Success;
+}
+
+Result KMemoryMap::Fill(u32 addr, u8 val, u32 size) {
+    while (size) {
+        u32 len = PageChunk(addr, size);
+        u8* page = GetWritePage(addr);
+
+        if (likely(page)) {
+            memset(page + (addr & PAGE_MASK), val, len);
+        } else {
+            for (u32 i = 0; i < len; i++) {
+                if (Write8(addr + i, val) != Success)
+                    return -1;
+            }
+        }
+        addr += len;
+        size -= len;
+    }
+    return Success;
+}
 
-	return Success;
+Result KMemoryMap::CopyFrom(KMemoryMap& src, u32 src_addr, u32 dst_addr, u32 size) {
+    while (size) {
+        u32 len = PageChunk(dst_addr, PageChunk(src_addr, size));
+        u8* from = src.GetReadPage(src_addr);
+        u8* to = GetWritePage(dst_addr);
+
+        if (likely(from && to)) {
+            // both maps can share the chunk
+            memmove(to + (dst_addr & PAGE_MASK), from + (src_addr & PAGE_MASK), len);
+        } else {
+            for (u32 i = 0; i < len; i++) {
+                u8 data;
+                if (src.Read8(src_addr + i, data) != Success)
+                    return -1;
+                if (Write8(dst_addr + i, data) != Success)
+                    return -1;
+            }
+        }
+        src_addr += len;
+        dst_addr += len;
+        size -= len;
+    }
+    return Success;
 }
 
 Result KMemoryMap::Read8(u32 addr, u8& out) {
@@ -68,31 +178,23 @@ Result KMemoryMap::Read8(u32 addr, u8& out) {
 
     if (unlikely(page > NUM_PAGES))
         return -1;
-    if (unlikely(m_pages[page].state == STATE_FREE))
+    if (unlikely(GetPage(page).state == STATE_FREE))
         return -1;
-    if (!(notcritical(m_pages[page].perm) & PERMISSION_R))
+    if (!(notcritical(GetPage(page).perm) & PERMISSION_R))
         return -1;
-    if (unlikely((u8)(m_pages[page].state) == STATE_IO))
+    if (unlikely((u8)(GetPage(page).state) == STATE_IO))
     {
-		if (m_pages[page].HW)
+		if (GetPage(page).HW)
 		{
-			out = m_pages[page].HW->Read8(addr);
+			KKernelLock lock(m_process->m_Kernel);
+			out = GetPage(page).HW->Read8(addr);
 			return Success;
 		}
     }
-	out = m_pages[page].data[offset];
-
-#ifdef RWLOG
-    if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-        LOG("read8 %08x %02x", addr, out);
-#endif
-
-#ifdef LOGHIGHACCESS
-
-	if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-        LOG("read8 %08x %02x", addr, out);
-#endif
+	out = GetPage(page).data[offset];
 
+    if (unlikely(s_num_watches))
+        LogAccess(addr, out, 1, WATCH_READ);
     return Success;
 }
 
@@ -102,7 +204,7 @@ Result KMemoryMap::Read16(u32 addr, u16& out) {
     u32 offset = addr & PAGE_MASK;
 
     // Cross-page reading.
-    if (unlikely(offset == PAGE_MASK && !((u8)(m_pages[page].state) == STATE_IO))) {
+    if (unlikely(offset == PAGE_MASK && !((u8)(GetPage(page).state) == STATE_IO))) {
         u8 lo, hi;
 
         if (unlikely(Read8(addr, lo) != Success))
@@ -113,45 +215,28 @@ Result KMemoryMap::Read16(u32 addr, u16& out) {
         // XXX: Verify:
         out = (lo<<8) | hi;
 
-#ifdef LOGHIGHACCESS
-		if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-            LOG("read16 %08x %04x", addr, out);
-#endif
-
-#ifdef RWLOG
-        if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-            LOG("read16 %08x %04x", addr, out);
-#endif
-
         return Success;
     }
 
     if(unlikely(page > NUM_PAGES))
         return -1;
-    if(unlikely(m_pages[page].state == STATE_FREE))
+    if(unlikely(GetPage(page).state == STATE_FREE))
         return -1;
-    if(!(notcritical(m_pages[page].perm) & PERMISSION_R))
+    if(!(notcritical(GetPage(page).perm) & PERMISSION_R))
         return -1;
-    if (unlikely((u8)(m_pages[page].state) == STATE_IO))
+    if (unlikely((u8)(GetPage(page).state) == STATE_IO))
     {
-		if (m_pages[page].HW)
+		if (GetPage(page).HW)
 		{
-			out = m_pages[page].HW->Read16(addr);
+			KKernelLock lock(m_process->m_Kernel);
+			out = GetPage(page).HW->Read16(addr);
 			return Success;
 		}
     }
-    out = *(u16*) &m_pages[page].data[offset];
-
-#ifdef RWLOG
-    if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-        LOG("read16 %08x %04x", addr, out);
-#endif
-
-#ifdef LOGHIGHACCESS
-	if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-        LOG("read16 %08x %04x", addr, out)
-#endif 
+    out = *(u16*) &GetPage(page).data[offset];
 
+    if (unlikely(s_num_watches))
+        LogAccess(addr, out, 2, WATCH_READ);
     return Success;
 }
 
@@ -162,7 +247,7 @@ Result KMemoryMap::Read32(u32 addr, u32& out) {
     u32 offset = addr & PAGE_MASK;
 
     // Cross-page reading.
-    if (unlikely(offset > (PAGE_MASK - 3) && !!((u8)(m_pages[page].state) == STATE_IO))) {
+    if (unlikely(offset > (PAGE_MASK - 3) && !!((u8)(GetPage(page).state) == STATE_IO))) {
         // XXX: Verify: TODO speedup
         u8 B0, B1, B2, B3;
 
@@ -176,45 +261,30 @@ Result KMemoryMap::Read32(u32 addr, u32& out) {
             return -1;
 
         out = (B0 << 24) | (B1 << 16) | (B2 << 8) | (B3 << 0);
-#ifdef LOGHIGHACCESS
-		if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-            LOG("read32 %08x %08x", addr, out)
-#endif 
-#ifdef RWLOG
-            if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-                LOG("read32 %08x %08x", addr, out)
-#endif
 
         return Success;
     }
 
     if(unlikely(page > NUM_PAGES))
         return -1;
-    if(unlikely(m_pages[page].state == STATE_FREE))
+    if(unlikely(GetPage(page).state == STATE_FREE))
         return -1;
-    if(!(notcritical(m_pages[page].perm) & PERMISSION_R))
+    if(!(notcritical(GetPage(page).perm) & PERMISSION_R))
         return -1;
-    if (unlikely((u8)(m_pages[page].state) == STATE_IO))
+    if (unlikely((u8)(GetPage(page).state) == STATE_IO))
     {
-		if (m_pages[page].HW)
+		if (GetPage(page).HW)
 		{
-			out = m_pages[page].HW->Read32(addr);
+			KKernelLock lock(m_process->m_Kernel);
+			out = GetPage(page).HW->Read32(addr);
 			return Success;
 		}
     }
 
-    out = *(u32*)&m_pages[page].data[offset];
-
-#ifdef RWLOG
-    if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-        LOG("read32 %08x %08x", addr, out)
-#endif
-
-#ifdef LOGHIGHACCESS
-		if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-        LOG("read32 %08x %08x", addr, out)
-#endif 
+    out = *(u32*)&GetPage(page).data[offset];
 
+    if (unlikely(s_num_watches))
+        LogAccess(addr, out, 4, WATCH_READ);
     return Success;
 }
 Result KMemoryMap::Read64(u32 addr, u64& out) {
@@ -229,53 +299,44 @@ Result KMemoryMap::Read64(u32 addr, u64& out) {
 
 Result KMemoryMap::Write8(u32 addr, u8 val) {
 
-#ifdef LOGHIGHACCESS
-	if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-        LOG("write8 %08x %02x", addr, val)
-#endif 
-#if defined(RWLOG) || defined(WLOG)
-        if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-            LOG("write8 %08x %02x", addr, val)
-#endif
+    if (unlikely(s_num_watches))
+        LogAccess(addr, val, 1, WATCH_WRITE);
 
     u32 page = addr/PAGE_SIZE;
     u32 offset = addr & PAGE_MASK;
 
     if(unlikely(page > NUM_PAGES))
         return -1;
-    if(unlikely(m_pages[page].state == STATE_FREE))
+    if(unlikely(GetPage(page).state == STATE_FREE))
         return -1;
-    if(!(notcritical(m_pages[page].perm) & PERMISSION_W))
+    if(!(notcritical(GetPage(page).perm) & PERMISSION_W))
         return -1;
-    if (unlikely((u8)(m_pages[page].state) == STATE_IO))
+    if (unlikely((u8)(GetPage(page).state) == STATE_IO))
     {
-		if (m_pages[page].HW)
+		if (GetPage(page).HW)
 		{
-			m_pages[page].HW->Write8(addr, val);
+			KKernelLock lock(m_process->m_Kernel);
+			GetPage(page).HW->Write8(addr, val);
 			return Success;
 		}
     }
 
-    m_pages[page].data[addr & PAGE_MASK] = val;
+    if (unlikely(GetPage(page).flags & PAGE_FLAG_CODE))
+        InvalidateCode(page);
+    GetPage(page).data[addr & PAGE_MASK] = val;
     return Success;
 }
 
 Result KMemoryMap::Write16(u32 addr, u16 val) {
 
-#ifdef LOGHIGHACCESS
-	if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-        LOG("write16 %08x %04x", addr, val)
-#endif 
+    if (unlikely(s_num_watches))
+        LogAccess(addr, val, 2, WATCH_WRITE);
 
-#if defined(RWLOG) || defined(WLOG)
-        if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-            LOG("write16 %08x %04x", addr, val)
-#endif
     u32 page = addr/PAGE_SIZE;
 
     u32 offset = addr & PAGE_MASK;
 
-    if (unlikely(offset == PAGE_MASK && !((u8)(m_pages[page].state) == STATE_IO))) {
+    if (unlikely(offset == PAGE_MASK && !((u8)(GetPage(page).state) == STATE_IO))) {
         // XXX: Verify:
         u8 B0 = (u8)(val >> 8), B1 = (u8)val;
 
@@ -289,33 +350,31 @@ Result KMemoryMap::Write16(u32 addr, u16 val) {
 
     if(unlikely(page > NUM_PAGES))
         return -1;
-    if(unlikely(m_pages[page].state == STATE_FREE))
+    if(unlikely(GetPage(page).state == STATE_FREE))
         return -1;
-    if(!(notcritical(m_pages[page].perm) & PERMISSION_W))
+    if(!(notcritical(GetPage(page).perm) & PERMISSION_W))
         return -1;
-    if (unlikely((u8)(m_pages[page].state) == STATE_IO))
+    if (unlikely((u8)(GetPage(page).state) == STATE_IO))
     {
-		if (m_pages[page].HW)
+		if (GetPage(page).HW)
 		{
-			m_pages[page].HW->Write16(addr, val);
+			KKernelLock lock(m_process->m_Kernel);
+			GetPage(page).HW->Write16(addr, val);
 			return Success;
 		}
     }
 
-    *(u16*) &m_pages[page].data[offset] = val;
+    if (unlikely(GetPage(page).flags & PAGE_FLAG_CODE))
+        InvalidateCode(page);
+    *(u16*) &GetPage(page).data[offset] = val;
     return Success;
 }
 
 Result KMemoryMap::Write32(u32 addr, u32 val) {
 
-#ifdef LOGHIGHACCESS
-	if (addr >= 0x1FF80000 && addr <= 0x1FF81FFF)
-        LOG("write32 %08x %08x", addr, val)
-#endif 
-#if defined(RWLOG) || defined(WLOG)
-        if (strcmp(LOGMODULE, m_process->GetName()) == 0)
-            LOG("write32 %08x %08x", addr, val)
-#endif
+    if (unlikely(s_num_watches))
+        LogAccess(addr, val, 4, WATCH_WRITE);
+
     u32 page = addr/PAGE_SIZE;
 
     u32 offset = addr & PAGE_MASK;
@@ -324,7 +383,7 @@ Result KMemoryMap::Write32(u32 addr, u32 val) {
         // XXX: Verify: TODO speedup
         u8 B0 = (u8)(val >> 24), B1 = (u8)(val >> 16), B2 = (u8)(val >> 8), B3 = (u8)val;
 
-        if (unlikely(Write8(addr, B0) != Success && !((u8)(m_pages[page].state) == STATE_IO)))
+        if (unlikely(Write8(addr, B0) != Success && !((u8)(GetPage(page).state) == STATE_IO)))
             return -1;
         if (unlikely(Write8(addr + 1, B1) != Success))
             return -1;
@@ -338,19 +397,22 @@ Result KMemoryMap::Write32(u32 addr, u32 val) {
 
     if(unlikely(page > NUM_PAGES))
         return -1;
-    if(unlikely(m_pages[page].state == STATE_FREE))
+    if(unlikely(GetPage(page).state == STATE_FREE))
         return -1;
-    if(!(notcritical(m_pages[page].perm) & PERMISSION_W))
+    if(!(notcritical(GetPage(page).perm) & PERMISSION_W))
         return -1;
-    if (unlikely((u8)(m_pages[page].state) == STATE_IO))
+    if (unlikely((u8)(GetPage(page).state) == STATE_IO))
     {
-		if (m_pages[page].HW)
+		if (GetPage(page).HW)
 		{
-			m_pages[page].HW->Write32(addr, val);
+			KKernelLock lock(m_process->m_Kernel);
+			GetPage(page).HW->Write32(addr, val);
 			return Success;
 		}
     }
-    *(u32*) &m_pages[page].data[offset] = val;
+    if (unlikely(GetPage(page).flags & PAGE_FLAG_CODE))
+        InvalidateCode(page);
+    *(u32*) &GetPage(page).data[offset] = val;
     return Success;
 }
 
@@ -375,6 +437,82 @@ Result KMemoryMap::IPCMap(u32 addr0, u32 addr1, u32 size, MemoryPermissions perm
     return Success;
 }
 
+Result KMemoryMap::MapIPCBuffer(KMemoryMap& src, u32 src_addr, u32 size, MemoryPermissions perm, u32* addr_out)
+{
+    u32 first = src_addr / PAGE_SIZE;
+    u32 count = ((src_addr & PAGE_MASK) + size + PAGE_MASK) / PAGE_SIZE;
+    if (count == 0) {
+        *addr_out = 0;
+        return Success;
+    }
+    if (first + count > NUM_PAGES)
+        return 0xE0A01BF5;
+    for (u32 i = 0; i < count; i++) {
+        const MemPage& page = src.GetPage(first + i);
+        if (!(page.state & STATE_IPC_ALLOWED) || page.data == NULL || page.chunk == NULL)
+            return 0xE0A01BF5;
+    }
+
+    // next fit, the search goes on where the last buffer ended and wraps around once
+    const u32 window_start = IPC_VA_START / PAGE_SIZE;
+    const u32 window_end = IPC_VA_END / PAGE_SIZE;
+    u32 page = m_ipc_next;
+    u32 run = 0;
+    for (u32 n = 0; n < window_end - window_start + count && run < count; n++) {
+        if (page >= window_end) {
+            page = window_start;
+            run = 0;
+        }
+        run = GetPage(page).state == STATE_FREE ? run + 1 : 0;
+        page++;
+    }
+    if (run < count)
+        return 0xE0A01BF5;
+
+    u32 start = page - count;
+    for (u32 i = 0; i < count; i++) {
+        // the buffer can be written from here without going through src, src has to translate its blocks again
+        src.InvalidateCode(first + i);
+        InvalidateCode(start + i);
+        const MemPage& from = src.GetPage(first + i);
+        MemPage& to = AllocPage(start + i);
+        to.data = from.data;
+        to.chunk = from.chunk;
+        to.state = MEMTYPE_MIRROR;
+        to.perm = perm;
+        to.flags = 0;
+        to.mirrored = (first + i) * PAGE_SIZE;
+        to.HW = NULL;
+        to.chunk->ref_count++;
+        UpdateFastPage(start + i);
+    }
+    m_ipc_next = page;
+
+    *addr_out = start * PAGE_SIZE + (src_addr & PAGE_MASK);
+    return Success;
+}
+
+Result KMemoryMap::UnmapIPCBuffer(KMemoryMap& src, u32 addr, u32 size)
+{
+    u32 first = addr / PAGE_SIZE;
+    u32 count = ((addr & PAGE_MASK) + size + PAGE_MASK) / PAGE_SIZE;
+    if (addr < IPC_VA_START || addr + size > IPC_VA_END)
+        return -1;
+    for (u32 i = 0; i < count; i++) {
+        if (GetPage(first + i).state != MEMTYPE_MIRROR)
+            return -1;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        InvalidateCode(first + i);
+        src.InvalidateCode(GetPage(first + i).mirrored / PAGE_SIZE);
+        ReleaseChunk(GetPage(first + i).chunk);
+        memset(&AllocPage(first + i), 0, sizeof(MemPage));
+        UpdateFastPage(first + i);
+    }
+    return Success;
+}
+
 Result KMemoryMap::ControlMemory(u32* addr_out, u32 addr0, u32 addr1, u32 size,
     MemoryOperation op, MemoryPermissions perm)
 {
@@ -400,7 +538,7 @@ Result KMemoryMap::ControlMemory(u32* addr_out, u32 addr0, u32 addr1, u32 size,
 				return 0xE0A01BF5;
 			// Create chunk.
 
-			MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+			MemChunk* chunk = new MemChunk();
 
 			if (chunk == NULL) {
 				return 0xE0A01BF5;
@@ -410,7 +548,7 @@ Result KMemoryMap::ControlMemory(u32* addr_out, u32 addr0, u32 addr1, u32 size,
 			chunk->data = &Mem_FCRAM[addr];
 			// Map it.
 			if (AddPages(addr0, size, chunk->data, chunk, perm, MEMTYPE_HEAP, NULL) != 0) {
-				free(chunk);
+				delete chunk;
 				return 0xE0A01BF5;
 			}
 
@@ -428,7 +566,7 @@ Result KMemoryMap::ControlMemory(u32* addr_out, u32 addr0, u32 addr1, u32 size,
             return 0xE0A01BF5;
         // Map it.
         if (AddPages(addr0, size, chunk->data, chunk, perm, MEMTYPE_HEAP, NULL) != 0) {
-            free(chunk);
+            delete chunk;
             return 0xE0A01BF5;
         }
 
@@ -513,15 +651,15 @@ Result KMemoryMap::QueryMemory(MemoryInfo* mem_out, PageInfo* page_out,
     if(addr >= NUM_PAGES)
         return -1;
 
-    MemPage* page = &m_pages[addr];
-    MemPage* prev = page;
+    u32 page = addr;
+    u32 prev = page;
     u32 size = 1;
 
     while(1) {
         if((addr+size) >= NUM_PAGES)
             break;
 
-        if((prev->state == page->state) && (prev->perm  == page->perm)) {
+        if((GetPage(prev).state == GetPage(page).state) && (GetPage(prev).perm  == GetPage(page).perm)) {
             prev = page;
             page++;
             size++;
@@ -531,8 +669,8 @@ Result KMemoryMap::QueryMemory(MemoryInfo* mem_out, PageInfo* page_out,
 
     mem_out->base_address = addr * PAGE_SIZE;
     mem_out->size = size * PAGE_SIZE;
-    mem_out->perm = prev->perm;
-    mem_out->state = prev->state;
+    mem_out->perm = GetPage(prev).perm;
+    mem_out->state = GetPage(prev).state;
 
     if(page_out != NULL)
         page_out->flags = 0;
@@ -541,22 +679,31 @@ Result KMemoryMap::QueryMemory(MemoryInfo* mem_out, PageInfo* page_out,
 }
 
 Result KMemoryMap::CreateChunk(MemChunk** chunk_out, u32 size) {
-    MemChunk* chunk = (MemChunk*) malloc(sizeof(MemChunk));
+    MemChunk* chunk = new MemChunk();
     u8* data = (u8*) calloc(size,sizeof(u8));
 
     if((chunk == NULL) || (data == NULL)) {
-        free(chunk);
+        delete chunk;
         free(data);
         return -1;
     }
 
     chunk->size = size;
     chunk->data = data;
+    chunk->owned = true;
 
     *chunk_out = chunk;
     return Success;
 }
 
+void KMemoryMap::ReleaseChunk(MemChunk* chunk)
+{
+    if (--chunk->ref_count == 0 && chunk->owned) {
+        free(chunk->data);
+        delete chunk;
+    }
+}
+
 Result KMemoryMap::AddPages(u32 addr, u32 size, u8* data, MemChunk* chunk,
     MemoryPermissions perm, MemoryState state, IOHW *HW)
 {
@@ -565,12 +712,15 @@ Result KMemoryMap::AddPages(u32 addr, u32 size, u8* data, MemChunk* chunk,
 
     // Fill in page-info.
     for(u32 i=0; i<size; i++) {
-        m_pages[addr+i].data = data + (i * PAGE_SIZE);
-        m_pages[addr+i].chunk = chunk;
-        m_pages[addr+i].state = state;
-        m_pages[addr+i].perm = perm;
-        m_pages[addr+i].mirrored = 0;
-        m_pages[addr+i].HW = HW;
+        InvalidateCode(addr + i);
+        MemPage& page = AllocPage(addr + i);
+        page.data = data + (i * PAGE_SIZE);
+        page.chunk = chunk;
+        page.state = state;
+        page.perm = perm;
+        page.mirrored = 0;
+        page.HW = HW;
+        UpdateFastPage(addr + i);
     }
 
     chunk->ref_count += size;
@@ -584,13 +734,16 @@ Result KMemoryMap::RemovePages(u32 addr, u32 size)
 
     // Fill in page-info.
     for(u32 i=0; i<size; i++) {
-        m_pages[addr+i].chunk->ref_count--;
-
-        m_pages[addr+i].data = NULL;
-        m_pages[addr+i].chunk = NULL;
-        m_pages[addr+i].state = STATE_FREE;
-        m_pages[addr+i].perm = PERMISSION_NONE;
-        m_pages[addr+i].mirrored = 0;
+        InvalidateCode(addr + i);
+        MemPage& page = AllocPage(addr + i);
+        ReleaseChunk(page.chunk);
+
+        page.data = NULL;
+        page.chunk = NULL;
+        page.state = STATE_FREE;
+        page.perm = PERMISSION_NONE;
+        page.mirrored = 0;
+        UpdateFastPage(addr + i);
     }
 
     return Success;
@@ -604,16 +757,23 @@ Result KMemoryMap::AddMirror(u32 mirror, u32 mirrored, u32 size,
     size /= PAGE_SIZE;
 
     for(u32 i=0; i<size; i++) {
+        // writes through the mirror miss the flags of the original, neither may keep blocks
+        InvalidateCode(mirror + i);
+        InvalidateCode(mirrored + i);
         // Fill in mirror pages.
-        m_pages[mirror+i].data  = m_pages[mirrored+i].data;
-        m_pages[mirror+i].chunk = m_pages[mirrored+i].chunk;
-        m_pages[mirror+i].state = MEMTYPE_MIRROR;
-        m_pages[mirror+i].perm = perm;
-        m_pages[mirror+i].mirrored = (mirrored + i) * PAGE_SIZE;
-        m_pages[mirror+i].chunk->ref_count++;
+        MemPage& page = AllocPage(mirror + i);
+        MemPage& original = AllocPage(mirrored + i);
+        page.data  = original.data;
+        page.chunk = original.chunk;
+        page.state = MEMTYPE_MIRROR;
+        page.perm = perm;
+        page.mirrored = (mirrored + i) * PAGE_SIZE;
+        page.chunk->ref_count++;
 
         // Mark mirrored pages as mirrored.
-        m_pages[mirrored+i].state = MEMTYPE_MIRRORED;
+        original.state = MEMTYPE_MIRRORED;
+        UpdateFastPage(mirror + i);
+        UpdateFastPage(mirrored + i);
     }
 
     return Success;
@@ -628,17 +788,22 @@ Result KMemoryMap::AddMirror(u32 mirror, u32 mirrored, u32 size,
 
     for (u32 i = 0; i<size; i++) {
         // Fill in mirror pages.
-		if (m_pages[mirrored + i].state != STATE_FREE)
+		if (GetPage(mirrored + i).state != STATE_FREE)
 		{
-			mapto->m_pages[mirror + i].data = m_pages[mirrored + i].data;
-			mapto->m_pages[mirror + i].chunk = m_pages[mirrored + i].chunk;
-			mapto->m_pages[mirror + i].state = MEMTYPE_MIRROR;
-			mapto->m_pages[mirror + i].perm = perm;
-			mapto->m_pages[mirror + i].mirrored = (mirrored + i) * PAGE_SIZE;
-			mapto->m_pages[mirror + i].chunk->ref_count++;
+			InvalidateCode(mirrored + i);
+			mapto->InvalidateCode(mirror + i);
+			MemPage& page = mapto->AllocPage(mirror + i);
+			page.data = GetPage(mirrored + i).data;
+			page.chunk = GetPage(mirrored + i).chunk;
+			page.state = MEMTYPE_MIRROR;
+			page.perm = perm;
+			page.mirrored = (mirrored + i) * PAGE_SIZE;
+			page.chunk->ref_count++;
 
 			// Mark mirrored pages as mirrored.
-			mapto->m_pages[mirrored + i].state = MEMTYPE_MIRRORED;
+			mapto->AllocPage(mirrored + i).state = MEMTYPE_MIRRORED;
+			mapto->UpdateFastPage(mirror + i);
+			mapto->UpdateFastPage(mirrored + i);
 		}
     }
 
@@ -658,21 +823,25 @@ Result KMemoryMap::RemoveMirror(u32 mirror, u32 mirrored, u32 size) {
 
     // Check that the region is continously mapped.
     for(u32 i=0; i<size; i++) {
-        if(m_pages[mirror+i].state != MEMTYPE_MIRROR)
+        if(GetPage(mirror+i).state != MEMTYPE_MIRROR)
             return -1;
-        if(m_pages[mirrored+i].state != MEMTYPE_MIRRORED)
+        if(GetPage(mirrored+i).state != MEMTYPE_MIRRORED)
             return -1;
-        if(m_pages[mirror+i].mirrored != (mirrored + i) * PAGE_SIZE)
+        if(GetPage(mirror+i).mirrored != (mirrored + i) * PAGE_SIZE)
             return -1;
     }
     
     for(u32 i=0; i<size; i++) {
         // Clear mirror pages.
-        m_pages[mirror+i].chunk->ref_count--;
-        memset(&m_pages[mirror+i], 0, sizeof(MemPage));
+        InvalidateCode(mirror + i);
+        InvalidateCode(mirrored + i);
+        ReleaseChunk(GetPage(mirror+i).chunk);
+        memset(&AllocPage(mirror+i), 0, sizeof(MemPage));
 
         // Restore state on mirrored pages.
-        m_pages[mirrored+i].state = MEMTYPE_HEAP;
+        AllocPage(mirrored+i).state = MEMTYPE_HEAP;
+        UpdateFastPage(mirror + i);
+        UpdateFastPage(mirrored + i);
     }
 
     return Success;
@@ -683,12 +852,120 @@ Result KMemoryMap::Reprotect(u32 addr, u32 size, MemoryPermissions perm) {
 	addr /= PAGE_SIZE;
 	size /= PAGE_SIZE;
 
-    for(u32 i=0; i<size; i++)
-        m_pages[addr+i].perm = perm;
+    for(u32 i=0; i<size; i++) {
+        InvalidateCode(addr + i);
+        AllocPage(addr+i).perm = perm;
+        UpdateFastPage(addr + i);
+    }
+
+    return Success;
+}
+
+void KMemoryMap::WatchCode(u32 addr) {
+    u32 page = addr / PAGE_SIZE;
+    if (GetPage(page).flags & PAGE_FLAG_CODE)
+        return;
+    AllocPage(page).flags |= PAGE_FLAG_CODE;
+    UpdateFastPage(page);
+}
+
+void KMemoryMap::InvalidateCode(u32 page) {
+    if (!(GetPage(page).flags & PAGE_FLAG_CODE))
+        return;
+    AllocPage(page).flags &= ~PAGE_FLAG_CODE;
+    UpdateFastPage(page);
+    m_process->InvalidateCode(page * PAGE_SIZE);
+}
+
+void KMemoryMap::UpdateFastPage(u32 page) {
+    const MemPage& p = GetPage(page);
+    u8* data = NULL;
+
+    // everything that has side effects or has to fault stays on the Read*/Write* path
+    if (p.state != STATE_FREE && (u8)(p.state) != STATE_IO)
+        data = p.data;
+    // watched pages have to take the slow path to be logged
+    if (unlikely(s_num_watches) && IsWatchedPage(page))
+        data = NULL;
+
+    m_fast_read[page] = (notcritical(p.perm) & PERMISSION_R) ? data : NULL;
+    m_fast_write[page] = ((notcritical(p.perm) & PERMISSION_W) && !(p.flags & PAGE_FLAG_CODE)) ? data : NULL;
+}
+
+bool KMemoryMap::IsWatchedPage(u32 page) {
+    for (u32 i = 0; i < s_num_watches; i++) {
+        if (page >= s_watches[i].start / PAGE_SIZE && page <= s_watches[i].end / PAGE_SIZE)
+            return true;
+    }
+    return false;
+}
 
+void KMemoryMap::LogAccess(u32 addr, u32 val, u32 size, u8 access) {
+    for (u32 i = 0; i < s_num_watches; i++) {
+        const MemoryWatch& watch = s_watches[i];
+        if (!(watch.access & access) || addr > watch.end || addr + size - 1 < watch.start)
+            continue;
+        if (watch.process[0] && strcmp(watch.process, m_process->GetName()) != 0)
+            continue;
+        LOG("%s %s%u %08x %0*x", m_process->GetName(), access == WATCH_READ ? "read" : "write", size * 8, addr, size * 2, val);
+        return;
+    }
+}
+
+void KMemoryMap::UpdateWatchedPages(u32 start, u32 end) {
+    for (u32 i = 0; i < s_maps.size(); i++) {
+        for (u32 page = start / PAGE_SIZE; page <= end / PAGE_SIZE && page < NUM_PAGES; page++)
+            s_maps[i]->UpdateFastPage(page);
+    }
+}
+
+Result KMemoryMap::AddWatch(u32 start, u32 end, u8 access, const char* process) {
+    if (s_num_watches == MAX_WATCHES || end < start || !(access & WATCH_RW))
+        return -1;
+
+    MemoryWatch& watch = s_watches[s_num_watches];
+    watch.start = start;
+    watch.end = end;
+    watch.access = access;
+    memset(watch.process, 0, sizeof(watch.process));
+    if (process)
+        strncpy(watch.process, process, sizeof(watch.process) - 1);
+    s_num_watches++;
+
+    UpdateWatchedPages(start, end);
     return Success;
 }
 
+Result KMemoryMap::AddWatch(const char* spec) {
+    char* next;
+    u32 start = strtoul(spec, &next, 16);
+    if (*next != '-')
+        return -1;
+    u32 end = strtoul(next + 1, &next, 16);
+
+    u8 access = WATCH_RW;
+    if (*next == ':') {
+        next++;
+        access = 0;
+        for (; *next == 'r' || *next == 'w'; next++)
+            access |= *next == 'r' ? WATCH_READ : WATCH_WRITE;
+    }
+    const char* process = NULL;
+    if (*next == '@')
+        process = next + 1;
+    else if (*next != '\0')
+        return -1;
+
+    return AddWatch(start, end, access, process);
+}
+
+void KMemoryMap::ClearWatches() {
+    u32 num = s_num_watches;
+    s_num_watches = 0;
+    for (u32 i = 0; i < num; i++)
+        UpdateWatchedPages(s_watches[i].start, s_watches[i].end);
+}
+
 Result KMemoryMap::AddCodeSegment(u32 addr, u32 size, u8* data,
     MemoryPermissions perm)
 {
@@ -706,7 +983,7 @@ Result KMemoryMap::AddCodeSegment(u32 addr, u32 size, u8* data,
 }
 Result KMemoryMap::MapIOData(u32 address, u32 size, u8*data, MemoryPermissions perm) {
     // Temporary implementation.
-    MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+    MemChunk* chunk = new MemChunk();
 
     if (chunk == NULL) {
         return -1;
@@ -723,7 +1000,7 @@ Result KMemoryMap::MapIOData(u32 address, u32 size, u8*data, MemoryPermissions p
 Result KMemoryMap::MapIOobj(u32 addr, u32 size, IOHW* obj, MemoryPermissions perm)
 {
 	// Temporary implementation.
-	MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+	MemChunk* chunk = new MemChunk();
 
 	if (chunk == NULL) {
 		return -1;
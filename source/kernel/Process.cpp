@@ -3,15 +3,17 @@
 //tools
 #define Read32(p) (p[0] | p[1] << 8 | p[2] << 16 | p[3] << 24)
 
-#define dyncoresizestart (1024 * 1024 * 20)
-
 bool KProcess::Synchronization(KThread* thread, u32 &error)
 {
     return true; //stall till the Process ends? TODO check that
 }
 KProcess::~KProcess()
 {
-	free(repretBuffer);
+	delete CreamBuffer;
+	delete CreamCache;
+#ifdef ARCHITECTURE_x86_64
+	delete m_jit;
+#endif
 }
 KProcess::KProcess(KCodeSet* codeset, u32 capabilities_num, u32* capabilities_ptr, KKernel* Kernel,bool is_firm_process)
 	: m_memory(this), m_limit(new KResourceLimit()), LINEAR_memory_virtual_address_userland(0x14000000) /*this is not like on the 3DS but it works with old and new NCCH*/
@@ -23,6 +25,7 @@ KProcess::KProcess(KCodeSet* codeset, u32 capabilities_num, u32* capabilities_pt
     memset(m_systemcallmask,   0, sizeof(m_systemcallmask));
 
     m_exheader_flags = 0;
+    m_invalidate_pending = false;
     m_codeset.SetObject(codeset);
 
     ParseArm11KernelCaps(capabilities_num, capabilities_ptr);
@@ -50,10 +53,13 @@ KProcess::KProcess(KCodeSet* codeset, u32 capabilities_num, u32* capabilities_pt
 
     codeset->MapInto(&m_memory, m_exheader_flags & (1 << 12));
 
-	repretBuffer = (char*)malloc(dyncoresizestart); //must be increasable later
-	repretBuffersize = dyncoresizestart;
-	repretBuffertop = 0;
-	CreamCache = new bb_map;
+	CreamBuffer = new CreamArena();
+	CreamCache = new bb_map(-1);
+	m_jit = NULL;
+#ifdef ARCHITECTURE_x86_64
+	if (dyncomjit)
+		m_jit = new ARM_Jit();
+#endif
 
 }
 
@@ -131,6 +137,40 @@ void KProcess::AddQuickCode(u8* buf, size_t size) {
     m_memory.AddCodeSegment(0x100000, size, buf, PERMISSION_RWX); // TEMP
 }
 
+void KProcess::InvalidateCode(u32 addr) {
+	// another core or a host thread, the core of the process may be in one of the blocks right now
+	KThread* current = m_Kernel->GetCurrentThread();
+	if (!current || current->m_owner->m_host_core != m_host_core) {
+		std::lock_guard<std::mutex> lock(m_invalidate_mutex);
+		m_invalidate_pages.push_back(addr);
+		m_invalidate_pending = true;
+		return;
+	}
+	CreamCache->ClearPage(addr);
+#ifdef ARCHITECTURE_x86_64
+	if (m_jit)
+		m_jit->InvalidatePage(addr);
+#endif
+}
+
+void KProcess::RunPendingInvalidations() {
+	if (!m_invalidate_pending)
+		return;
+	std::vector<u32> pages;
+	{
+		std::lock_guard<std::mutex> lock(m_invalidate_mutex);
+		pages.swap(m_invalidate_pages);
+		m_invalidate_pending = false;
+	}
+	for (size_t i = 0; i < pages.size(); i++) {
+		CreamCache->ClearPage(pages[i]);
+#ifdef ARCHITECTURE_x86_64
+		if (m_jit)
+			m_jit->InvalidatePage(pages[i]);
+#endif
+	}
+}
+
 Result KProcess::WaitSynchronization(s64 timeout) {
     return -1; // TODO
 }
@@ -7,7 +7,20 @@ SwitchContext* sc;                  // 0xFFF2D0A8 (can change occasionally)
 
 KScheduler::KScheduler()
 {
-
+    m_scheduler_count = 0;
+    m_switch_context = false;
+    m_intr_thread_in_progress = false;
+    m_swap_intr_core = false;
+    m_need_post_intr_reschedule = false;
+    m_core_num = 0;
+    m_scheduler_thread_count = 0;
+    m_thread_high_prio = 0;
+    m_thread_low_prio = 0;
+    m_scheduler_thread = NULL;
+    m_unknown2 = 0;
+    m_unknown3 = 0;
+    memset(m_schedule_entries, 0, sizeof(m_schedule_entries));
+    m_round_next = NULL;
 }
 
 KScheduler::~KScheduler()
@@ -18,36 +31,38 @@ KScheduler::~KScheduler()
 void KScheduler::AddToScheduler(KThread* add_thread)    // add current_scheduler-> in front of all members?
 {
     s16 core = m_core_num;
+    s32 prio = KScheduler::GetQueuePrio(add_thread->m_thread_prio);
+    add_thread->m_queued_prio = prio;   // the thread may change its prio while queued
 
-    if (m_schedule_entries[add_thread->m_thread_prio].next == NULL)
+    if (m_schedule_entries[prio].next == NULL)
     {
-        if (KScheduler::GetPrioType(add_thread->m_thread_prio) == PRIO_TYPE_HIGH)    // highest bit of prio to differentiate between high prio and low prio
+        if (KScheduler::GetPrioType(prio) == PRIO_TYPE_HIGH)    // highest bit of prio to differentiate between high prio and low prio
         {
-            m_thread_high_prio |= 0x80000000UL >> KScheduler::GetPrioField(add_thread->m_thread_prio); // shift the top bit down to the right bit in the field
+            m_thread_high_prio |= 0x80000000UL >> KScheduler::GetPrioField(prio); // shift the top bit down to the right bit in the field
         }
         else
         {
-            m_thread_low_prio |= 0x80000000UL >> KScheduler::GetPrioField(add_thread->m_thread_prio);
+            m_thread_low_prio |= 0x80000000UL >> KScheduler::GetPrioField(prio);
         }
     }
 
-    add_thread->m_prev = m_schedule_entries[add_thread->m_thread_prio].prev;    // prev entry becomes previous for thread
+    add_thread->m_prev = m_schedule_entries[prio].prev;    // prev entry becomes previous for thread
     add_thread->m_next = NULL;  // this thread is the new last
     
-    if (m_schedule_entries[add_thread->m_thread_prio].prev == NULL) // if entry->prev is NULL, entry->next is the new thread
+    if (m_schedule_entries[prio].prev == NULL) // if entry->prev is NULL, entry->next is the new thread
     {
-        m_schedule_entries[add_thread->m_thread_prio].next = add_thread;
+        m_schedule_entries[prio].next = add_thread;
     }
     else
     {
-        m_schedule_entries[add_thread->m_thread_prio].prev->m_next = add_thread; // otherwise, the next thread from entry->prev is the new thread
+        m_schedule_entries[prio].prev->m_next = add_thread; // otherwise, the next thread from entry->prev is the new thread
     }
 
-    m_schedule_entries[add_thread->m_thread_prio].prev = add_thread; // then set entry->prev to the new thread
+    m_schedule_entries[prio].prev = add_thread; // then set entry->prev to the new thread
 
     m_scheduler_thread_count++; 
 
-    if (core == m_core_num) // if the core being scheduled has not changed since the beginning of this function, swap context
+    if (core == m_core_num && current_thread) // if the core being scheduled has not changed since the beginning of this function, swap context
     {
        if (current_thread->m_thread_prio > add_thread->m_thread_prio) // and if the prio of the current thread (0xFFFF9000) is greater than the thread being added, we need to do some scheduling because this thread needs to run
        {
@@ -64,41 +79,50 @@ void KScheduler::AddToScheduler(KThread* add_thread)    // add current_scheduler
 
 void KScheduler::RemoveFromScheduler(KThread* sub_thread)   // add current_scheduler-> in front of all members?
 {
-    if (m_schedule_entries[sub_thread->m_thread_prio].next != NULL && m_schedule_entries[sub_thread->m_thread_prio].prev->m_thread_id == m_schedule_entries[sub_thread->m_thread_prio].next->m_thread_id)  // if entry->next and entry->prev are non-zero and the same, 
+    s32 prio = sub_thread->m_queued_prio;
+
+    if (m_round_next == sub_thread) // the round goes on with the thread that would have been next
+    {
+        m_round_next = Successor(sub_thread);
+    }
+
+    if (m_schedule_entries[prio].next == sub_thread && m_schedule_entries[prio].prev == sub_thread)  // if it is the only thread with this prio
     {   
-        if (KScheduler::GetPrioType(sub_thread->m_thread_prio) == PRIO_TYPE_HIGH)    // highest bit of prio to differentiate between high prio and low prio
+        if (KScheduler::GetPrioType(prio) == PRIO_TYPE_HIGH)    // highest bit of prio to differentiate between high prio and low prio
         {
-            bit32 r_mask = 0x80000000UL >> KScheduler::GetPrioField(sub_thread->m_thread_prio);   // shift the top bit down to the right bit in the field
+            bit32 r_mask = 0x80000000UL >> KScheduler::GetPrioField(prio);   // shift the top bit down to the right bit in the field
             m_thread_high_prio &= ~r_mask;  // clear the bit in the mask
         }
         else
         {
-            bit32 r_mask = 0x80000000UL >> KScheduler::GetPrioField(sub_thread->m_thread_prio);
+            bit32 r_mask = 0x80000000UL >> KScheduler::GetPrioField(prio);
             m_thread_low_prio &= ~r_mask;
         }
     }
 
     if (sub_thread->m_prev == NULL) // if the old thread to be removed is the first
     {
-        m_schedule_entries[sub_thread->m_thread_prio].next = sub_thread->m_next;  // set entry-> next to the thread after the one being removed
+        m_schedule_entries[prio].next = sub_thread->m_next;  // set entry-> next to the thread after the one being removed
     }
     else
     {
         sub_thread->m_prev->m_next = sub_thread->m_next;        // set it to skip over the old thread
     }
 
-    if (sub_thread->m_next == NULL) // link things together without the old thread in there
+    if (sub_thread->m_next != NULL) // link things together without the old thread in there
     {
         sub_thread->m_next->m_prev = sub_thread->m_prev;
     }
     else
     {
-        m_schedule_entries[sub_thread->m_thread_prio].prev = sub_thread->m_next;
+        m_schedule_entries[prio].prev = sub_thread->m_prev;
     }
 
+    sub_thread->m_prev = NULL;
+    sub_thread->m_next = NULL;
     m_scheduler_thread_count--;
 
-    if (current_thread->m_thread_id == sub_thread->m_thread_id) // if the current thread is the one being removed, do another schedule and trigger intr 8 for the other core
+    if (current_thread && current_thread->m_thread_id == sub_thread->m_thread_id) // if the current thread is the one being removed, do another schedule and trigger intr 8 for the other core
     {
         m_switch_context = true;
         m_swap_intr_core = true;
@@ -178,6 +202,44 @@ KThread* KScheduler::ScheduleThreads(int z)
     return NULL;
 }
 
+KThread* KScheduler::FirstThread(s32 from)
+{
+    if (from < PRIO_FIELD_COUNT)
+    {
+        bit32 high = m_thread_high_prio & (0xFFFFFFFFUL >> from);    // mask out the higher prios
+        if (high)
+            return m_schedule_entries[Common::CountLeadingZeros(high)].next;
+        from = PRIO_FIELD_COUNT;
+    }
+    if (from < PRIO_COUNT)
+    {
+        bit32 low = m_thread_low_prio & (0xFFFFFFFFUL >> (from - PRIO_FIELD_COUNT));
+        if (low)
+            return m_schedule_entries[PRIO_FIELD_COUNT + Common::CountLeadingZeros(low)].next;
+    }
+    return NULL;
+}
+
+KThread* KScheduler::Successor(KThread* thread)
+{
+    if (thread->m_next)
+        return thread->m_next;
+    return FirstThread(thread->m_queued_prio + 1);
+}
+
+void KScheduler::StartRound()
+{
+    m_round_next = FirstThread(PRIO_HIGH);
+}
+
+KThread* KScheduler::NextInRound()
+{
+    KThread* thread = m_round_next;
+    if (thread)
+        m_round_next = Successor(thread);
+    return thread;
+}
+
 void KScheduler::SwitchKernelContext(int z)
 {
     if (!m_switch_context)
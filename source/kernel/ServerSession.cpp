@@ -8,12 +8,18 @@ void KServerSession::Destroy() {
 }
 bool KServerSession::Synchronization(KThread* thread, u32 &error)
 {
-    KThread * tnew = m_owner->m_Client.SynGetNextPrio();
-    if (tnew && !m_owner->m_Server.m_waitingForCmdResp)
+    KThread * tnew;
+    while ((tnew = m_owner->m_Client.SynGetNextPrio()) && !m_owner->m_Server.m_waitingForCmdResp)
     {
+        s32 ret = m_owner->Communicate(tnew, thread, false);
+        if (ret != Success)
+        {
+            // the client gets the error, the server goes on with the next request
+            m_owner->m_Client.SynFree(ret, tnew);
+            continue;
+        }
         m_owner->m_Server.m_waitingForCmdResp = tnew;
         m_owner->m_Server.m_processingCmd = thread;
-        m_owner->Communicate(tnew, thread, false);
         return false;
     }
 
@@ -43,13 +49,14 @@ s32 KServerSession::reply(KThread * sender)
 		return -1;
 	}
 
-    m_owner->Communicate(sender, m_waitingForCmdResp,true);
+    // a reply that can not be passed on still wakes the client, with the error
+    s32 ret = m_owner->Communicate(sender, m_waitingForCmdResp,true);
 
-    m_owner->m_Client.SynFree(0, m_waitingForCmdResp);
+    m_owner->m_Client.SynFree(ret, m_waitingForCmdResp);
 
     m_processingCmd = NULL;
     m_waitingForCmdResp = NULL;
-    return 0;
+    return ret;
 }
 bool KServerSession::IsInstanceOf(ClassName name) {
     if (name == KServerSession::name)
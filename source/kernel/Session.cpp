@@ -1,6 +1,11 @@
+#define LOG_CLASS LOGCLASS_IPC
+
 #include "Kernel.h"
 
+// IPC messages are logged at debug level, the calls are only compiled in if LOG_MIN_LEVEL allows it
+#if LOG_MIN_LEVEL <= LOGLEVEL_DEBUG
 #define LOGCOMMUNICATION
+#endif
 
 //tools
 
@@ -8,10 +13,18 @@
 KSession::KSession(KPort * owner) : m_Server(this), m_Client(this)
 {
     m_owner = owner;
+    m_messages = 0;
+    m_bytes = 0;
+    m_num_buffers = 0;
+    m_buffer_map = NULL;
+    m_buffer_src = NULL;
+    m_p9_channel = -1;
 }
 KSession::~KSession()
 {
-
+    if (m_Server.m_processingCmd && m_Server.m_processingCmd->m_ipc_session == this)
+        m_Server.m_processingCmd->m_ipc_session = NULL;
+    LOGDEBUG("session %s closed after %" PRIu64 " messages %" PRIu64 " bytes", m_owner ? m_owner->m_Name : "-", m_messages, m_bytes);
 }
 bool KSession::IsInstanceOf(ClassName name) {
     if (name == KSession::name)
@@ -28,40 +41,72 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
     {
         if (m_owner)
         {
-            LOG("responding %s <- %s port %s", recver->m_owner->GetName(), sender->m_owner->GetName(), m_owner->m_Name);
+            LOGDEBUG("responding %s <- %s port %s", recver->m_owner->GetName(), sender->m_owner->GetName(), m_owner->m_Name);
         }
         else
         {
-            LOG("responding %s <- %s", recver->m_owner->GetName(), sender->m_owner->GetName());
+            LOGDEBUG("responding %s <- %s", recver->m_owner->GetName(), sender->m_owner->GetName());
         }
     }
     else
     {
         if (m_owner)
         {
-            LOG("sending %s -> %s port %s", sender->m_owner->GetName(), recver->m_owner->GetName(), m_owner->m_Name);
+            LOGDEBUG("sending %s -> %s port %s", sender->m_owner->GetName(), recver->m_owner->GetName(), m_owner->m_Name);
         }
         else
         {
-            LOG("sending %s -> %s", sender->m_owner->GetName(), recver->m_owner->GetName());
+            LOGDEBUG("sending %s -> %s", sender->m_owner->GetName(), recver->m_owner->GetName());
         }
     }
 #endif
-    u32 cmd = *senddata++;
-    *recvdata++ = cmd;
+    // a request that was never answered leaves its buffers behind
+    if (!IsResponse && m_num_buffers)
+        UnmapBuffers();
+
+    u32 cmd = *senddata;
     u32 translated = cmd & 0x3F;
     u32 nomal = (cmd >> 6) & 0x3F;
 #ifdef LOGCOMMUNICATION
-    LOG("cmd %08x", cmd);
+    LOGDEBUG("cmd %08x", cmd);
 #endif
-    for (u32 i = 0; i < nomal; i++)
+    if (1 + nomal + translated > IPC_MAX_WORDS)
     {
-        u32 data = *senddata++;
+        // the caller hands the error to the client, the receiver never sees the message
+        XDSERROR("IPC message %08x does not fit in the command buffer", cmd);
+        if (IsResponse)
+        {
+            sender->m_ipc_session = NULL;
+            UnmapBuffers();
+        }
+        return SVCERROR_INVALID_PARAMS;
+    }
+
+    if (IsResponse)
+        sender->m_ipc_session = NULL;
+    else
+        recver->m_ipc_session = this;
+
+    // the header and the plain words go in one copy, most messages have nothing else
+    memcpy(recvdata, senddata, (1 + nomal) * 4);
+    m_messages++;
+    m_bytes += (1 + nomal) * 4;
 #ifdef LOGCOMMUNICATION
-        LOG("data %08x", data);
+    if (LOGLEVEL_DEBUG >= log_levels[LOG_CLASS])
+    {
+        for (u32 i = 1; i <= nomal; i++)
+            LOGDEBUG("data %08x", senddata[i]);
+    }
 #endif
-        *recvdata++ = data;
+    if (translated == 0)
+    {
+        if (IsResponse)
+            UnmapBuffers();
+        return Success;
     }
+    senddata += 1 + nomal;
+    recvdata += 1 + nomal;
+
     for (u32 i = 0; i < translated; )
     {
         u32 descriptor = *senddata++;
@@ -77,7 +122,7 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
             {
                 u32 PID = sender->m_owner->GetProcessID();
 #ifdef LOGCOMMUNICATION
-                LOG("PID %08x", PID);
+                LOGDEBUG("PID %08x", PID);
 #endif
                 i+= 2;
                 *recvdata++ = descriptor;
@@ -115,7 +160,7 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
 					}
 
 #ifdef LOGCOMMUNICATION
-                    LOG("handle %08x -> %08x", data, newhand);
+                    LOGDEBUG("handle %08x -> %08x", data, newhand);
 #endif
                     *recvdata++ = newhand;
                     i++;
@@ -139,7 +184,7 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
                         sender->m_owner->GetHandleTable()->CloseHandle(data);
                     }
 #ifdef LOGCOMMUNICATION
-                    LOG("handle close %08x -> %08x", data, newhand);
+                    LOGDEBUG("handle close %08x -> %08x", data, newhand);
 #endif
                     *recvdata++ = newhand;
                     i++;
@@ -173,32 +218,26 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
 
 
 #ifdef LOGCOMMUNICATION
-            LOG("TLS cpy %08x (id %01x size %06x) (%08x %08x)", srcaddr, (descriptor >> 10) & 0xF, (descriptor >> 14), targed, tarsize);
+            LOGDEBUG("TLS cpy %08x (id %01x size %06x) (%08x %08x)", srcaddr, (descriptor >> 10) & 0xF, (descriptor >> 14), targed, tarsize);
 #endif
             if (targed != 0 && tarsize >= sizewanted)
             {
-                for (u32 i = 0; i < sizewanted; i++)
+                s32 ret = recver->m_owner->getMemoryMap()->CopyFrom(*sender->m_owner->getMemoryMap(), srcaddr, targed, sizewanted);
+                if (ret != Success)
                 {
-                    u8 data = 0;
-                    s32 ret = sender->m_owner->getMemoryMap()->Read8(srcaddr + i, data);
-                    if (ret != Success)
-                    {
-                        LOG("IPC Communicate error reading from %08x", srcaddr);
-                        break;
-                    }
-#ifdef LOGCOMMUNICATION
-					printf("%02x",data);
-#endif
-                    recver->m_owner->getMemoryMap()->Write8(targed + i, data);
-                    if (ret != Success)
-                    {
-                        LOG("IPC Communicate error writing from %08x", targed);
-                        break;
-                    }
+                    LOG("IPC Communicate error copying from %08x to %08x", srcaddr, targed);
                 }
                 *recvdata = targed;
+                m_bytes += sizewanted;
 #ifdef LOGCOMMUNICATION
-			LOG("");
+                if (LOGLEVEL_DEBUG >= log_levels[LOG_CLASS])
+                {
+                    u8* data = new u8[sizewanted];
+                    memset(data, 0, sizewanted);
+                    recver->m_owner->getMemoryMap()->ReadN(targed, data, sizewanted);
+                    LogHex(LOG_CLASS, LOGLEVEL_DEBUG, data, sizewanted);
+                    delete[] data;
+                }
 #endif
 			}
             else
@@ -220,7 +259,7 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
 
             u32 data = *senddata++;
 #ifdef LOGCOMMUNICATION
-            LOG("IPC translate RW %08x (id %01x size %06x)", data, (descriptor >> 4) & 0xF, (descriptor >> 8));
+            LOGDEBUG("IPC translate RW %08x (id %01x size %06x)", data, (descriptor >> 4) & 0xF, (descriptor >> 8));
 #endif
             *recvdata++ = data;
             i += 2;
@@ -236,7 +275,7 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
 
             u32 data = *senddata++;
 #ifdef LOGCOMMUNICATION
-            LOG("IPC translate RO %08x (id %01x size %06x)", data, (descriptor >> 4) & 0xF, (descriptor >> 8));
+            LOGDEBUG("IPC translate RO %08x (id %01x size %06x)", data, (descriptor >> 4) & 0xF, (descriptor >> 8));
 #endif
             *recvdata++ = data;
             i += 2;
@@ -263,32 +302,54 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
             *recvdata = descriptor;
             recvdata++;
             u32 data = *senddata++;
-			size = (((size + data + 0xFFF) / 0x1000) * 0x1000) - data;
-            int j = 0x04000000;
-            for (; j < 0x08000000; j += 0x1000)
+            u32 j = 0;
+            if (IsResponse)
             {
-                if (sender->m_owner->getMemoryMap()->IPCMap(j, data, size, perm, recver->m_owner->getMemoryMap()) == Success)
-                    break;
+                // the server hands a buffer back, the client gets its own address
+                j = data;
+                for (u32 k = 0; k < m_num_buffers; k++)
+                {
+                    if (m_buffers[k].addr == data)
+                    {
+                        j = m_buffers[k].src_addr;
+                        break;
+                    }
+                }
+            }
+            else if (m_num_buffers < IPC_MAX_WORDS / 2)
+            {
+                KMemoryMap* map = recver->m_owner->getMemoryMap();
+                if (map->MapIPCBuffer(*sender->m_owner->getMemoryMap(), data, size, perm, &j) == Success)
+                {
+                    m_buffers[m_num_buffers].addr = j;
+                    m_buffers[m_num_buffers].size = size;
+                    m_buffers[m_num_buffers].src_addr = data;
+                    m_num_buffers++;
+                    m_buffer_map = map;
+                    m_buffer_src = sender->m_owner->getMemoryMap();
+                }
+                else
+                {
+                    XDSERROR("IPC could not map %08x (size %08x) into %s", data, size, recver->m_owner->GetName());
+                }
             }
-            if (j >= 0x08000000)
-                LOG("OUT OF IPC MEM implement cleanup plz");
 
 #ifdef LOGCOMMUNICATION
             switch (descriptor & 0xE)
             {
             case 0xA:
-                LOG("IPC map RO %08x (size %08x) to %08x", data, size, j);
+                LOGDEBUG("IPC map RO %08x (size %08x) to %08x", data, size, j);
                 break;
             case 0xC:
-                LOG("IPC map WO %08x (size %08x) to %08x", data, size, j);
+                LOGDEBUG("IPC map WO %08x (size %08x) to %08x", data, size, j);
                 break;
             case 0xE:
-                LOG("IPC map RW %08x (size %08x) to %08x", data, size, j);
+                LOGDEBUG("IPC map RW %08x (size %08x) to %08x", data, size, j);
                 break;
             }
 #endif
 
-            *recvdata++ = j + (data &0xFFF);
+            *recvdata++ = j;
             i += 2;
             break;
         }
@@ -300,5 +361,17 @@ s32 KSession::Communicate(KThread* sender, KThread* recver, bool IsResponse)
             break;
         }
     }
+    if (IsResponse)
+        UnmapBuffers();
     return Success;
+}
+
+void KSession::UnmapBuffers()
+{
+    for (u32 i = 0; i < m_num_buffers; i++)
+    {
+        if (m_buffer_map->UnmapIPCBuffer(*m_buffer_src, m_buffers[i].addr, m_buffers[i].size) != Success)
+            XDSERROR("IPC could not unmap %08x (size %08x)", m_buffers[i].addr, m_buffers[i].size);
+    }
+    m_num_buffers = 0;
 }
\ No newline at end of file
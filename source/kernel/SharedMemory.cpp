@@ -21,10 +21,10 @@ s32 KSharedMemory::map(u32 addr, u32 myperm, u32 otherpem, KProcess *caller) //t
 		{
 			if (caller == m_owner)
 			{
-				MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+				MemChunk* chunk = new MemChunk();
 
 				if (chunk == NULL) {
-					free(chunk);
+					delete chunk;
 					return -1;
 				}
 
@@ -34,10 +34,10 @@ s32 KSharedMemory::map(u32 addr, u32 myperm, u32 otherpem, KProcess *caller) //t
 			}
 			else
 			{
-				MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+				MemChunk* chunk = new MemChunk();
 
 				if (chunk == NULL) {
-					free(chunk);
+					delete chunk;
 					return -1;
 				}
 
@@ -69,10 +69,10 @@ s32 KSharedMemory::map(u32 addr, u32 myperm, u32 otherpem, KProcess *caller) //t
 		{
 			if (caller == m_owner)
 			{
-				MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+				MemChunk* chunk = new MemChunk();
 
 				if (chunk == NULL) {
-					free(chunk);
+					delete chunk;
 					return -1;
 				}
 
@@ -82,10 +82,10 @@ s32 KSharedMemory::map(u32 addr, u32 myperm, u32 otherpem, KProcess *caller) //t
 			}
 			else
 			{
-				MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+				MemChunk* chunk = new MemChunk();
 
 				if (chunk == NULL) {
-					free(chunk);
+					delete chunk;
 					return -1;
 				}
 
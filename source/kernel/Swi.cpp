@@ -1,7 +1,12 @@
+#define LOG_CLASS LOGCLASS_KERNEL
+
 #include "Kernel.h"
 //todo correct ResourceLimmit attatch and use ResourceLimmit, timeout, the port stuff is not 100% correct
 
+// each svc at debug level
+#if LOG_MIN_LEVEL <= LOGLEVEL_DEBUG
 #define SWILOG
+#endif
 //#define SHOWCLEAREVENT
 
 struct CodeSetInfo
@@ -51,8 +56,9 @@ static u64 Read64(uint8_t p[8])
 
 void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 {
+    KKernelLock lock(currentThread->m_owner->m_Kernel);
 #ifdef SWILOG
-    //LOG("Process %s thread %d syscall %02X", currentThread->m_owner->GetName(), currentThread->m_thread_id, swi);
+    //LOGDEBUG("Process %s thread %d syscall %02X", currentThread->m_owner->GetName(), currentThread->m_thread_id, swi);
 #endif
     if (!currentThread->m_owner->m_systemcallmask[swi])
     {
@@ -74,7 +80,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[0] = ret;
 
 #ifdef SWILOG
-        LOG("Process %s thread %u ControlMemory (%08x %08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, op, addr0, addr1, size, perm, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u ControlMemory (%08x %08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, op, addr0, addr1, size, perm, Reg[0], Reg[1]);
 #endif
 
         return;
@@ -92,7 +98,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[5] = Pinfo.flags;
         Reg[0] = ret;
 #ifdef SWILOG
-        LOG("Process %s thread %u QueryMemory (%08x | %08x %08x %08x %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, addr, Reg[0], Reg[1], Reg[2], Reg[3], Reg[4], Reg[5]);
+        LOGDEBUG("Process %s thread %u QueryMemory (%08x | %08x %08x %08x %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, addr, Reg[0], Reg[1], Reg[2], Reg[3], Reg[4], Reg[5]);
 #endif
         return;
     }
@@ -103,7 +109,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		u32 processorcount = Reg[2];
 		Reg[0] = 0;
 #ifdef SWILOG
-		LOG("Process %s thread %u SetProcessAffinityMask stub (%08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, process, affinitymask, processorcount, Reg[0]);
+		LOGDEBUG("Process %s thread %u SetProcessAffinityMask stub (%08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, process, affinitymask, processorcount, Reg[0]);
 #endif
 		return;
 	}
@@ -113,7 +119,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		u32 idealprocessor = Reg[1];
 		Reg[0] = 0;
 #ifdef SWILOG
-		LOG("Process %s thread %u SetProcessAffinityMask stub (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, process, idealprocessor, Reg[0]);
+		LOGDEBUG("Process %s thread %u SetProcessAffinityMask stub (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, process, idealprocessor, Reg[0]);
 #endif
 		return;
 	}
@@ -147,7 +153,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateThread %u (%08x %08x %08x %08x %08x | %08x %08x)", 
+            LOGDEBUG("Process %s thread %u CreateThread %u (%08x %08x %08x %08x %08x | %08x %08x)", 
                 currentThread->m_owner->GetName(), currentThread->m_thread_id, thread->m_thread_id, 
                 entrypoint, arg,  stacktop,  threadpriority, processorid, 
                 Reg[0], Reg[1]);
@@ -162,7 +168,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[1] = hand;
 
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateThread %u (%08x %08x %08x %08x %08x | %08x %08x)", 
+        LOGDEBUG("Process %s thread %u CreateThread %u (%08x %08x %08x %08x %08x | %08x %08x)", 
             currentThread->m_owner->GetName(), currentThread->m_thread_id, thread->m_thread_id,
             entrypoint, arg, stacktop, threadpriority, processorid,
             Reg[0], Reg[1]);
@@ -174,7 +180,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		currentThread->m_owner->m_Kernel->ReScheduler();
 		currentThread->stop();
 #ifdef SWILOG
-		LOG("Process %s thread %u ExitThread", currentThread->m_owner->GetName(), currentThread->m_thread_id);
+		LOGDEBUG("Process %s thread %u ExitThread", currentThread->m_owner->GetName(), currentThread->m_thread_id);
 #endif
 		return;
 	}
@@ -182,14 +188,12 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
     {
 		u64 nanoseconds = Reg[0] | ((u64)Reg[1] << 32);
 #ifdef SWILOG
-		LOG("Process %s thread %u SleepThread %llu", currentThread->m_owner->GetName(), currentThread->m_thread_id, nanoseconds);
+		LOGDEBUG("Process %s thread %u SleepThread %llu", currentThread->m_owner->GetName(), currentThread->m_thread_id, nanoseconds);
 #endif
-		KLinkedList<KSynchronizationObject> *list = new KLinkedList<KSynchronizationObject>();
-		list->AddItem(currentThread);
-		currentThread->SyncStall(list, true);
+		KSynchronizationObject* self = currentThread;
+		currentThread->SyncStall(&self, 1, true);
 
-		currentThread->m_owner->m_Kernel->m_Timedevent.AddItem(currentThread);
-		currentThread->m_owner->m_Kernel->FireNextTimeEvent(currentThread, nanoseconds + 1);
+		currentThread->m_owner->m_Kernel->FireNextTimeEvent(currentThread, KKernel::NanosecondsToTicks(nanoseconds) + 1);
 
         currentThread->m_owner->m_Kernel->ReScheduler();
         return;
@@ -206,14 +210,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetThreadPriority (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u GetThreadPriority (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[1] = th->m_thread_prio;
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u GetThreadPriority (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u GetThreadPriority (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -230,14 +234,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u SetThreadPriority (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[1], Reg[0]);
+            LOGDEBUG("Process %s thread %u SetThreadPriority (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[1], Reg[0]);
 #endif 
             return;
         }
-        th->m_thread_prio = Reg[1];
+        currentThread->m_owner->m_Kernel->SetThreadPriority(th, Reg[1]);
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u SetThreadPriority (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[1], Reg[0]);
+        LOGDEBUG("Process %s thread %u SetThreadPriority (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[1], Reg[0]);
 #endif 
         return;
     }
@@ -251,20 +255,21 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		u32 envp = Reg[5]; //not used
 		u32 unused;
 #ifdef SWILOG
-		LOG("Process %s thread %u Run (%08x %08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, prio, stacksize, argc, argv, envp, Reg[0]);
+		LOGDEBUG("Process %s thread %u Run (%08x %08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, prio, stacksize, argc, argv, envp, Reg[0]);
 #endif
 		KProcess* process = (KProcess*)*currentThread->m_owner->GetHandleTable()->GetHandle<KProcess>(handle);
 		if (process == NULL)
 		{
 			Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u Run (%08x %08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, prio, stacksize, argc, argv, envp, Reg[0]);
+			LOGDEBUG("Process %s thread %u Run (%08x %08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, prio, stacksize, argc, argv, envp, Reg[0]);
 #endif
 			return;
 		}
 		process->getMemoryMap()->ControlMemory(&unused, 0x10000000 - stacksize, 0, stacksize, OPERATION_COMMIT, PERMISSION_RW);
 
 		KThread * thread = new KThread(SERVICECORE, process); //todo find out when to use the other core
+		thread->m_thread_prio = prio;
 		u32 startaddr = (process->m_exheader_flags & (1 << 12)) ? 0x14000000 : 0x00100000;
 		thread->m_context.reg_15 = startaddr;
 		thread->m_context.pc = startaddr;
@@ -275,7 +280,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		Reg[0] = 0;
 
 #ifdef SWILOG
-		LOG("Process %s thread %u Run (%08x %08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, prio, stacksize, argc, argv, envp, Reg[0]);
+		LOGDEBUG("Process %s thread %u Run (%08x %08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, prio, stacksize, argc, argv, envp, Reg[0]);
 #endif
 		return;
 
@@ -289,14 +294,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateMutex (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u CreateMutex (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[0] = 0;
         Reg[1] = hand;
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateMutex (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u CreateMutex (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -308,14 +313,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u ReleaseMutex (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+            LOGDEBUG("Process %s thread %u ReleaseMutex (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif
             return;
         }
         th->Release();
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u ReleaseMutex (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+        LOGDEBUG("Process %s thread %u ReleaseMutex (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif
         return;
     }
@@ -330,14 +335,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, count, maxcount, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u CreateSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, count, maxcount, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[0] = 0;
         Reg[1] = hand;
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, count, maxcount, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u CreateSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, count, maxcount, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -351,7 +356,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u ReleaseSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, releaseCount, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u ReleaseSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, releaseCount, Reg[0], Reg[1]);
 #endif 
             return;
         }
@@ -359,7 +364,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[0] = th->ReleaseSemaphore(releaseCount, out_count);
         Reg[1] = out_count;
 #ifdef SWILOG
-        LOG("Process %s thread %u ReleaseSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, releaseCount, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u ReleaseSemaphore (%08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, releaseCount, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -373,14 +378,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateEvent (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u CreateEvent (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[0] = 0;
         Reg[1] = hand;
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateEvent (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u CreateEvent (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -393,7 +398,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u SignalEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+            LOGDEBUG("Process %s thread %u SignalEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif 
             return;
         }
@@ -401,7 +406,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         th->Triggerevent();
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u SignalEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+        LOGDEBUG("Process %s thread %u SignalEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif 
         return;
     }
@@ -414,7 +419,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 
 			Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u ClearEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+			LOGDEBUG("Process %s thread %u ClearEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif 
 			return;
 		}
@@ -423,7 +428,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		Reg[0] = 0;
 #ifdef SWILOG
 #ifdef SHOWCLEAREVENT
-		LOG("Process %s thread %u ClearEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+		LOGDEBUG("Process %s thread %u ClearEvent (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif 
 #endif 
 		return;
@@ -438,14 +443,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateTimer (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateTimer (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
 #endif
 			return;
 		}
 		Reg[0] = 0;
 		Reg[1] = hand;
 #ifdef SWILOG
-		LOG("Process %s thread %u CreateTimer (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
+		LOGDEBUG("Process %s thread %u CreateTimer (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, resettype, Reg[0], Reg[1]);
 #endif
 		return;
 	}
@@ -460,13 +465,13 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u SetTimer (%08x %I64d %I64d | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, initial, interval, Reg[0]);
+			LOGDEBUG("Process %s thread %u SetTimer (%08x %I64d %I64d | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, initial, interval, Reg[0]);
 #endif 
 			return;
 		}
 		Reg[0] = th->SetTimer(initial, interval);
 #ifdef SWILOG
-		LOG("Process %s thread %u SetTimer (%08x %I64d %I64d | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, initial, interval, Reg[0]);
+		LOGDEBUG("Process %s thread %u SetTimer (%08x %I64d %I64d | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, initial, interval, Reg[0]);
 #endif 
 		return;
 	}
@@ -479,14 +484,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u CancelTimer (%08x| %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+			LOGDEBUG("Process %s thread %u CancelTimer (%08x| %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif 
 			return;
 		}
 		th->Cancel();
 		Reg[0] = Success;
 #ifdef SWILOG
-		LOG("Process %s thread %u CancelTimer (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
+		LOGDEBUG("Process %s thread %u CancelTimer (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0]);
 #endif 
 		return;
 	}
@@ -503,14 +508,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateMemoryBlock (%08x %08x %08x %08x| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, otherperm, addr, size, myperm, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateMemoryBlock (%08x %08x %08x %08x| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, otherperm, addr, size, myperm, Reg[0], Reg[1]);
 #endif
 			return;
 		}
 		Reg[0] = 0;
 		Reg[1] = hand;
 #ifdef SWILOG
-		LOG("Process %s thread %u CreateMemoryBlock (%08x %08x %08x %08x| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, otherperm, addr, size, myperm, Reg[0], Reg[1]);
+		LOGDEBUG("Process %s thread %u CreateMemoryBlock (%08x %08x %08x %08x| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, otherperm, addr, size, myperm, Reg[0], Reg[1]);
 #endif
 		return;
 	}
@@ -525,13 +530,13 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u MapMemoryBlock (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, addr, myperm, otherperm, Reg[0]);
+			LOGDEBUG("Process %s thread %u MapMemoryBlock (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, addr, myperm, otherperm, Reg[0]);
 #endif    
 			return;
 		}
 		Reg[0] = th->map(addr,myperm,otherperm,currentThread->m_owner);
 #ifdef SWILOG
-		LOG("Process %s thread %u MapMemoryBlock (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, addr, myperm, otherperm, Reg[0]);
+		LOGDEBUG("Process %s thread %u MapMemoryBlock (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, addr, myperm, otherperm, Reg[0]);
 #endif
 		return;
 	}
@@ -544,14 +549,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateAddressArbiter (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u CreateAddressArbiter (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[0] = 0;
         Reg[1] = hand;
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateAddressArbiter (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u CreateAddressArbiter (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -568,14 +573,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u ArbitrateAddress (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, arbiter, addr, type, value, Reg[0]);
+            LOGDEBUG("Process %s thread %u ArbitrateAddress (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, arbiter, addr, type, value, Reg[0]);
 #endif    
             return;
         }
         if (addr & 3) {
             Reg[0] = 0xD8E007F1;
 #ifdef SWILOG
-            LOG("Process %s thread %u ArbitrateAddress (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, arbiter, addr, type, value, Reg[0]);
+            LOGDEBUG("Process %s thread %u ArbitrateAddress (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, arbiter, addr, type, value, Reg[0]);
 #endif
             return;
         }
@@ -583,7 +588,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 
 
 #ifdef SWILOG
-        LOG("Process %s thread %u ArbitrateAddress (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, arbiter, addr, type, value, Reg[0]);
+        LOGDEBUG("Process %s thread %u ArbitrateAddress (%08x %08x %08x %08x| %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, arbiter, addr, type, value, Reg[0]);
 #endif
         return;
     }
@@ -595,14 +600,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CloseHandle (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
+            LOGDEBUG("Process %s thread %u CloseHandle (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
 #endif
         }
         else
         {
             Reg[0] = 0;
 #ifdef SWILOG
-            LOG("Process %s thread %u CloseHandle (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
+            LOGDEBUG("Process %s thread %u CloseHandle (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
 #endif
         }
         return;
@@ -617,16 +622,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u WaitSynchronization1 (%08x %" PRIx64 " | % 08x % 08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, timeout, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u WaitSynchronization1 (%08x %" PRIx64 " | % 08x % 08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, timeout, Reg[0], Reg[1]);
 #endif    
             return;
         }
 
-        KLinkedList<KSynchronizationObject> *list = new KLinkedList<KSynchronizationObject>();
-        list->AddItem(th);
-        currentThread->SyncStall(list, true);
+        currentThread->SyncStall(&th, 1, true);
 #ifdef SWILOG
-        LOG("Process %s thread %u WaitSynchronization1 (%08x %" PRIx64 ") stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, timeout);
+        LOGDEBUG("Process %s thread %u WaitSynchronization1 (%08x %" PRIx64 ") stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, timeout);
 #endif    
         return;
     }
@@ -637,7 +640,13 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         u32 waitall = Reg[3];
         u64 timeout = Reg[0] | ((u64)Reg[4] << 32);
 
-        KLinkedList<KSynchronizationObject> *list = new KLinkedList<KSynchronizationObject>();
+        if (handleCount < 0 || handleCount > MAX_WAIT_OBJECTS)
+        {
+            Reg[0] = SVCERROR_OUT_OF_RANGE;
+            return;
+        }
+        KSynchronizationObject* objects[MAX_WAIT_OBJECTS];
+        u32 count = 0;
         for (int i = 0; i < handleCount; i++)
         {
             u32 handle;
@@ -645,21 +654,20 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = -1;
 #ifdef SWILOG
-                LOG("Process %s thread %u WaitSynchronizationN (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, waitall, Reg[0], Reg[1]);
+                LOGDEBUG("Process %s thread %u WaitSynchronizationN (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, waitall, Reg[0], Reg[1]);
 #endif
-                delete list;
                 return;
             }
             KSynchronizationObject* th = (KSynchronizationObject*)*currentThread->m_owner->GetHandleTable()->GetHandle<KSynchronizationObject>(handle);
 #ifdef SWILOG
-            LOG("handle: %08x", handle);
+            LOGDEBUG("handle: %08x", handle);
 #endif
             if (th) //todo send error message
-                list->AddItem(th);
+                objects[count++] = th;
         }
-        currentThread->SyncStall(list, waitall);
+        currentThread->SyncStall(objects, count, waitall != 0);
 #ifdef SWILOG
-        LOG("Process %s thread %u WaitSynchronizationN (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, waitall, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u WaitSynchronizationN (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, waitall, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -684,7 +692,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-                LOG("Process %s thread %u DuplicateHandle (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, original, Reg[0],Reg[1]);
+                LOGDEBUG("Process %s thread %u DuplicateHandle (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, original, Reg[0],Reg[1]);
 #endif
                 return;
             }
@@ -695,24 +703,26 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u DuplicateHandle (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, original, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u DuplicateHandle (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, original, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[0] = 0;
         Reg[1] = hand;
 #ifdef SWILOG
-        LOG("Process %s thread %u DuplicateHandle (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, original, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u DuplicateHandle (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, original, Reg[0], Reg[1]);
 #endif
         return;
     }
 	case 0x28:
 	{
-		Reg[0] = currentThread->m_core->Getticks();
-		Reg[1] = currentThread->m_core->Getticks() >> 32;
+		u64 ticks = currentThread->m_owner->m_Kernel->GetSystemTick();
+		Reg[0] = (u32)ticks;
+		Reg[1] = (u32)(ticks >> 32);
 #ifdef SWILOG
-		LOG("Process %s thread %u GetSystemTick ( | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
+		LOGDEBUG("Process %s thread %u GetSystemTick ( | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
 #endif
+		return;
 	}
 
     case 0x2A: //GetSystemInfo(u64*out,Handle process, ProcessInfoType type)
@@ -732,7 +742,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             break;
         }
 #ifdef SWILOG
-        LOG("Process %s thread %u GetSystemInfo (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, type, param, Reg[0], Reg[1], Reg[2]);
+        LOGDEBUG("Process %s thread %u GetSystemInfo (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, type, param, Reg[0], Reg[1], Reg[2]);
 #endif
         return;
     }
@@ -773,7 +783,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             break;
         }
 #ifdef SWILOG
-        LOG("Process %s thread %u GetProcessInfo (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, type, Reg[0], Reg[1], Reg[2]);
+        LOGDEBUG("Process %s thread %u GetProcessInfo (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, type, Reg[0], Reg[1], Reg[2]);
 #endif
         return;
     }
@@ -786,13 +796,13 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetThreadInfo (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, type, Reg[0]);
+            LOGDEBUG("Process %s thread %u GetThreadInfo (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, type, Reg[0]);
 #endif
             return;
         }
         Reg[0] = SVCERROR_INVALID_ENUM_VALUE;
 #ifdef SWILOG
-        LOG("Process %s thread %u GetThreadInfo (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, type, Reg[0]);
+        LOGDEBUG("Process %s thread %u GetThreadInfo (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, type, Reg[0]);
 #endif
         return;
     }
@@ -855,16 +865,8 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             temp = temp->next;
         }
 #ifdef SWILOG
-        LOG("Process %s thread %u ConnectToPort (%08x | %08x %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, Reg[0], Reg[1]);
-        for (int i = 0; i < 8; i++)
-        {
-            u8 data = 0;
-            currentThread->m_owner->getMemoryMap()->Read8(pointer + i, data);
-            if (data == NULL)
-                break;
-            printf("%c", data);
-        }
-        printf("\n");
+        LOGDEBUG("Process %s thread %u ConnectToPort (%08x | %08x %08x) stub", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, Reg[0], Reg[1]);
+        LOGDEBUG("%s", name);
 #endif        
         return;
     }
@@ -876,16 +878,15 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u SendSyncRequest (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
+            LOGDEBUG("Process %s thread %u SendSyncRequest (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
 #endif
             return;
         }
-        KLinkedList<KSynchronizationObject> *list = new KLinkedList<KSynchronizationObject>();
-        list->AddItem(KSession);
-        currentThread->SyncStall(list, true);
+        KSynchronizationObject* session = KSession;
+        currentThread->SyncStall(&session, 1, true);
         Reg[0] = Success;
 #ifdef SWILOG
-        LOG("Process %s thread %u SendSyncRequest (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
+        LOGDEBUG("Process %s thread %u SendSyncRequest (%08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0]);
 #endif
 
         return;
@@ -913,7 +914,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = -1;
 #ifdef SWILOG
-            LOG("Process %s thread %u OpenProcess (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, ID, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u OpenProcess (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, ID, Reg[0], Reg[1]);
 #endif
             return;
         }
@@ -923,14 +924,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u OpenProcess (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, ID, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u OpenProcess (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, ID, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[1] = hand;
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u OpenProcess (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, ID, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u OpenProcess (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, ID, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -950,14 +951,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetProcessId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u GetProcessId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[1] = th->GetProcessID();
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u GetProcessId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u GetProcessId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -973,14 +974,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetThreadId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u GetThreadId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif           
             return;
         }
         Reg[0] = 0;
         Reg[1] = pr->m_thread_id;
 #ifdef SWILOG
-        LOG("Process %s thread %u GetThreadId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u GetThreadId (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif   
         return;
     }
@@ -993,7 +994,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetResourceLimit (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0],Reg[1]);
+            LOGDEBUG("Process %s thread %u GetResourceLimit (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0],Reg[1]);
 #endif           
             return;
         }
@@ -1003,14 +1004,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetResourceLimit (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u GetResourceLimit (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[1] = outhand;
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u GetResourceLimit (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u GetResourceLimit (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, hand, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -1025,7 +1026,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_POINTER;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1040,7 +1041,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1055,7 +1056,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_INVALID_PARAMS;
 #ifdef SWILOG
-                LOG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+                LOGDEBUG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
                 return;
             }
@@ -1063,19 +1064,19 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_OUT_OF_RANGE;
 #ifdef SWILOG
-                LOG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+                LOGDEBUG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
                 return;
             }
 
             s64 out_data = pr->GetMaxValue(data); //gets data from KResourceLimitobj + 0x8
 #ifdef SWILOG
-            LOG("%08x -> %08x", data, (u32)out_data);
+            LOGDEBUG("%08x -> %08x", data, (u32)out_data);
 #endif
             currentThread->m_owner->getMemoryMap()->Write64(names_ptr + i * 8, out_data);
         }
 #ifdef SWILOG
-        LOG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+        LOGDEBUG("Process %s thread %u GetResourceLimitLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
         Reg[0] = 0;
         return;
@@ -1091,7 +1092,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_POINTER;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1099,7 +1100,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_OUT_OF_RANGE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1109,7 +1110,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1124,7 +1125,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_INVALID_PARAMS;
 #ifdef SWILOG
-                LOG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+                LOGDEBUG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
                 return;
             }
@@ -1132,21 +1133,21 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_OUT_OF_RANGE;
 #ifdef SWILOG
-                LOG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+                LOGDEBUG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
                 return;
             }
 
             s64 out_data = pr->GetCurrentValue(data);
 #ifdef SWILOG
-            LOG("%08x -> %08x", data, (u32)out_data);
+            LOGDEBUG("%08x -> %08x", data, (u32)out_data);
 #endif
             currentThread->m_owner->getMemoryMap()->Write64(names_ptr + i * 8, out_data);
         }
 
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+        LOGDEBUG("Process %s thread %u GetResourceLimitCurrentValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
         return;
     }
@@ -1197,16 +1198,8 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreatePort (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, maxhandle, Reg[0], Reg[1], Reg[2]);
-            for (int i = 0; i < 8; i++)
-            {
-                u8 data = 0;
-                currentThread->m_owner->getMemoryMap()->Read8(pointer + i, data);
-                if (data == NULL)
-                    break;
-                printf("%c", data);
-            }
-            printf("\n");
+            LOGDEBUG("Process %s thread %u CreatePort (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, maxhandle, Reg[0], Reg[1], Reg[2]);
+            LOGDEBUG("%s", name);
 #endif 
             return;
         }
@@ -1216,16 +1209,8 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreatePort (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, maxhandle, Reg[0], Reg[1], Reg[2]);
-            for (int i = 0; i < 8; i++)
-            {
-                u8 data = 0;
-                currentThread->m_owner->getMemoryMap()->Read8(pointer + i, data);
-                if (data == NULL)
-                    break;
-                printf("%c", data);
-            }
-            printf("\n");
+            LOGDEBUG("Process %s thread %u CreatePort (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, maxhandle, Reg[0], Reg[1], Reg[2]);
+            LOGDEBUG("%s", name);
 #endif 
             return;
         }
@@ -1234,16 +1219,8 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[2] = hand2;
 
 #ifdef SWILOG
-        LOG("Process %s thread %u CreatePort (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, maxhandle, Reg[0], Reg[1], Reg[2]);
-        for (int i = 0; i < 8; i++)
-        {
-            u8 data = 0;
-            currentThread->m_owner->getMemoryMap()->Read8(pointer + i, data);
-            if (data == NULL)
-                break;
-            printf("%c", data);
-        }
-        printf("\n");
+        LOGDEBUG("Process %s thread %u CreatePort (%08x %08x | %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, maxhandle, Reg[0], Reg[1], Reg[2]);
+        LOGDEBUG("%s", name);
 #endif        
         return;
     }
@@ -1256,7 +1233,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateSessionToPort (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u CreateSessionToPort (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
 #endif
             return;
         }
@@ -1282,7 +1259,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             Reg[0] = -1; //todo the correct error
         }
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateSessionToPort (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u CreateSessionToPort (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
 #endif        
         return;
     }
@@ -1296,7 +1273,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateSession (| %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1], Reg[2]);
+            LOGDEBUG("Process %s thread %u CreateSession (| %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1], Reg[2]);
 #endif
             return;
         }
@@ -1305,7 +1282,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateSession (| %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1], Reg[2]);
+            LOGDEBUG("Process %s thread %u CreateSession (| %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1], Reg[2]);
 #endif
             return;
         }
@@ -1314,7 +1291,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[1] = hand1;
         Reg[2] = hand2;
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateSession (| %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1], Reg[2]);
+        LOGDEBUG("Process %s thread %u CreateSession (| %08x %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1], Reg[2]);
 #endif
         return;
     }
@@ -1326,7 +1303,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u AcceptSession (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u AcceptSession (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
 #endif
             return;
         }
@@ -1338,7 +1315,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u AcceptSession (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u AcceptSession (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
 #endif
             return;
         }
@@ -1346,7 +1323,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[0] = 0;
         Reg[1] = hand;
 #ifdef SWILOG
-        LOG("Process %s thread %u AcceptSession (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u AcceptSession (%08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -1363,7 +1340,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-                LOG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
+                LOGDEBUG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
 #endif
                 return;
             }
@@ -1372,13 +1349,19 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = ret;
 #ifdef SWILOG
-                LOG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
+                LOGDEBUG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
 #endif
                 return;
             }*/ //don't do anything here
         }
 
-        KLinkedList<KSynchronizationObject> *list = new KLinkedList<KSynchronizationObject>();
+        if (handleCount < 0 || handleCount > MAX_WAIT_OBJECTS)
+        {
+            Reg[0] = SVCERROR_OUT_OF_RANGE;
+            return;
+        }
+        KSynchronizationObject* objects[MAX_WAIT_OBJECTS];
+        u32 count = 0;
         for (int i = 0; i < handleCount; i++)
         {
             u32 handle;
@@ -1386,21 +1369,20 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = -1;
 #ifdef SWILOG
-                LOG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
+                LOGDEBUG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
 #endif
-                delete list;
                 return;
             }
             KSynchronizationObject* th = (KSynchronizationObject*)*currentThread->m_owner->GetHandleTable()->GetHandle<KSynchronizationObject>(handle);
 #ifdef SWILOG
-            LOG("handle: %08x", handle);
+            LOGDEBUG("handle: %08x", handle);
 #endif
             if (th) //todo send error message
-                list->AddItem(th);
+                objects[count++] = th;
         }
-        currentThread->SyncStall(list, false);
+        currentThread->SyncStall(objects, count, false);
 #ifdef SWILOG
-        LOG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u ReplyAndReceive (%08x %08x %08x | %08x %08x) stub + not 100 correct", currentThread->m_owner->GetName(), currentThread->m_thread_id, pointer, handleCount, replyTarget, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -1416,13 +1398,13 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u BindInterrupt (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, priority, isManualClear, Reg[0]);
+            LOGDEBUG("Process %s thread %u BindInterrupt (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, priority, isManualClear, Reg[0]);
 #endif
             return;
         }
         Reg[0] = currentThread->m_owner->m_Kernel->RegisterInterrupt(name, obj, priority, isManualClear);
 #ifdef SWILOG
-        LOG("Process %s thread %u BindInterrupt (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, priority, isManualClear, Reg[0]);
+        LOGDEBUG("Process %s thread %u BindInterrupt (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, priority, isManualClear, Reg[0]);
 #endif
         return;
     }
@@ -1436,13 +1418,13 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u UnbindInterrupt (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, Reg[0]);
+            LOGDEBUG("Process %s thread %u UnbindInterrupt (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, Reg[0]);
 #endif
             return;
         }
         Reg[0] = currentThread->m_owner->m_Kernel->UnRegisterInterrupt(name, obj);
 #ifdef SWILOG
-        LOG("Process %s thread %u UnbindInterrupt (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, Reg[0]);
+        LOGDEBUG("Process %s thread %u UnbindInterrupt (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, name, syncObject, Reg[0]);
 #endif
         return;
     }
@@ -1453,7 +1435,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		Reg[0] = 0;
 
 #ifdef SWILOG
-		LOG("Process %s thread %u StoreProcessDataCache (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, addr, size, Reg[0]);
+		LOGDEBUG("Process %s thread %u StoreProcessDataCache (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, addr, size, Reg[0]);
 #endif
 		return;
 	}
@@ -1464,7 +1446,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		Reg[0] = 0;
 
 #ifdef SWILOG
-		LOG("Process %s thread %u FlushProcessDataCache (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, addr, size, Reg[0]);
+		LOGDEBUG("Process %s thread %u FlushProcessDataCache (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, addr, size, Reg[0]);
 #endif
 		return;
 	}
@@ -1504,7 +1486,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = -1;
 #ifdef SWILOG
-			LOG("Process %s thread %u StartInterProcessDma failed (%08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, dstProcessID, dstAddress, srcProcessID, srcAddress, size, config);
+			LOGDEBUG("Process %s thread %u StartInterProcessDma failed (%08x %08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, dstProcessID, dstAddress, srcProcessID, srcAddress, size, config);
 #endif
 			return;
 		}
@@ -1517,60 +1499,70 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u StartInterProcessDma (%s %08x %s %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, dstProcess->GetName(), dstAddress, srcProcess->GetName(), srcAddress, size, config);
+			LOGDEBUG("Process %s thread %u StartInterProcessDma (%s %08x %s %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, dstProcess->GetName(), dstAddress, srcProcess->GetName(), srcAddress, size, config);
 #endif
 			return;
 		}
 
 #ifdef SWILOG
-        LOG("Process %s thread %u StartInterProcessDma (%s %08x %s %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, dstProcess->GetName(), dstAddress, srcProcess->GetName(), srcAddress, size, config);
-        LOG("DmaConfig:");
-        LOG("  channel_sel: %d", dmaConfig.channel_sel);
-        LOG("  endian_swap_size: %d (0x%02X)", dmaConfig.endian_swap_size, dmaConfig.endian_swap_size);
-        LOG("  flags: %d (0x%02X)", dmaConfig.flags, dmaConfig.flags);
-        LOG("  padding: %d (0x%02X)", dmaConfig.padding, dmaConfig.padding);
-        LOG("  SubDmaConfig Destination:");
-        LOG("    peripheral_id: %d (0x%02X)", dmaConfig.dst_cfg.peripheral_id, dmaConfig.dst_cfg.peripheral_id);
-        LOG("    type: %d (0x%02X)", dmaConfig.dst_cfg.type, dmaConfig.dst_cfg.type);
-        LOG("    unk3: %d (0x%04X)", dmaConfig.dst_cfg.unk3, dmaConfig.dst_cfg.unk3);
-        LOG("    transfer_size: %d (0x%04X)", dmaConfig.dst_cfg.transfer_size, dmaConfig.dst_cfg.transfer_size);
-        LOG("    unk4: %d (0x%04X)", dmaConfig.dst_cfg.unk4, dmaConfig.dst_cfg.unk4);
-        LOG("    transfer_stride: %d (0x%04X)", dmaConfig.dst_cfg.transfer_stride, dmaConfig.dst_cfg.transfer_stride);
-        LOG("  SubDmaConfig Source:");
-        LOG("    peripheral_id: %d (0x%02X)", dmaConfig.src_cfg.peripheral_id, dmaConfig.src_cfg.peripheral_id);
-        LOG("    type: %d (0x%02X)", dmaConfig.src_cfg.type, dmaConfig.src_cfg.type);
-        LOG("    unk3: %d (0x%04X)", dmaConfig.src_cfg.unk3, dmaConfig.src_cfg.unk3);
-        LOG("    transfer_size: %d (0x%04X)", dmaConfig.src_cfg.transfer_size, dmaConfig.src_cfg.transfer_size);
-        LOG("    unk4: %d (0x%04X)", dmaConfig.src_cfg.unk4, dmaConfig.src_cfg.unk4);
-        LOG("    transfer_stride: %d (0x%04X)", dmaConfig.src_cfg.transfer_stride, dmaConfig.src_cfg.transfer_stride);
-
-#endif
-		for (u32 i = 0; i < size;)
+        LOGDEBUG("Process %s thread %u StartInterProcessDma (%s %08x %s %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, dstProcess->GetName(), dstAddress, srcProcess->GetName(), srcAddress, size, config);
+        LOGDEBUG("DmaConfig:");
+        LOGDEBUG("  channel_sel: %d", dmaConfig.channel_sel);
+        LOGDEBUG("  endian_swap_size: %d (0x%02X)", dmaConfig.endian_swap_size, dmaConfig.endian_swap_size);
+        LOGDEBUG("  flags: %d (0x%02X)", dmaConfig.flags, dmaConfig.flags);
+        LOGDEBUG("  padding: %d (0x%02X)", dmaConfig.padding, dmaConfig.padding);
+        LOGDEBUG("  SubDmaConfig Destination:");
+        LOGDEBUG("    peripheral_id: %d (0x%02X)", dmaConfig.dst_cfg.peripheral_id, dmaConfig.dst_cfg.peripheral_id);
+        LOGDEBUG("    type: %d (0x%02X)", dmaConfig.dst_cfg.type, dmaConfig.dst_cfg.type);
+        LOGDEBUG("    unk3: %d (0x%04X)", dmaConfig.dst_cfg.unk3, dmaConfig.dst_cfg.unk3);
+        LOGDEBUG("    transfer_size: %d (0x%04X)", dmaConfig.dst_cfg.transfer_size, dmaConfig.dst_cfg.transfer_size);
+        LOGDEBUG("    unk4: %d (0x%04X)", dmaConfig.dst_cfg.unk4, dmaConfig.dst_cfg.unk4);
+        LOGDEBUG("    transfer_stride: %d (0x%04X)", dmaConfig.dst_cfg.transfer_stride, dmaConfig.dst_cfg.transfer_stride);
+        LOGDEBUG("  SubDmaConfig Source:");
+        LOGDEBUG("    peripheral_id: %d (0x%02X)", dmaConfig.src_cfg.peripheral_id, dmaConfig.src_cfg.peripheral_id);
+        LOGDEBUG("    type: %d (0x%02X)", dmaConfig.src_cfg.type, dmaConfig.src_cfg.type);
+        LOGDEBUG("    unk3: %d (0x%04X)", dmaConfig.src_cfg.unk3, dmaConfig.src_cfg.unk3);
+        LOGDEBUG("    transfer_size: %d (0x%04X)", dmaConfig.src_cfg.transfer_size, dmaConfig.src_cfg.transfer_size);
+        LOGDEBUG("    unk4: %d (0x%04X)", dmaConfig.src_cfg.unk4, dmaConfig.src_cfg.unk4);
+        LOGDEBUG("    transfer_stride: %d (0x%04X)", dmaConfig.src_cfg.transfer_stride, dmaConfig.src_cfg.transfer_stride);
+
+#endif
+		if (dmaConfig.dst_cfg.type == 1 && dmaConfig.dst_cfg.transfer_stride != 0)
+		{
+			// the destination wraps around every stride bytes, copy one stride at a time
+			u32 stride = dmaConfig.dst_cfg.transfer_stride;
+			for (u32 i = 0; i < size; i += stride)
+				dstProcess->getMemoryMap()->CopyFrom(*srcProcess->getMemoryMap(), srcAddress + i, dstAddress, (size - i) < stride ? (size - i) : stride);
+		}
+		else
 		{
-			u8 val8;
-			u16 val16;
-			u32 val32;
-			switch (dmaConfig.dst_cfg.type)
+			for (u32 i = 0; i < size;)
 			{
-			case 1:
-				srcProcess->getMemoryMap()->Read8(srcAddress + i, val8);
-				dstProcess->getMemoryMap()->Write8(dstAddress + (i % dmaConfig.dst_cfg.transfer_stride), val8);
-				i++;
-				break;
-			case 2:
-				srcProcess->getMemoryMap()->Read16(srcAddress + i, val16);
-				dstProcess->getMemoryMap()->Write16(dstAddress + (i % dmaConfig.dst_cfg.transfer_stride), val16);
-				i+=2;
-				break;
-			case 4:
-				srcProcess->getMemoryMap()->Read32(srcAddress + i, val32);
-				dstProcess->getMemoryMap()->Write32(dstAddress + (i % dmaConfig.dst_cfg.transfer_stride), val32);
-				i += 4;
-				break;
-			default:
-				LOG("error dmaConfig.dst_cfg.type 0x%02X not supported yet", dmaConfig.dst_cfg.type);
-				i++;
-				break;
+				u8 val8;
+				u16 val16;
+				u32 val32;
+				switch (dmaConfig.dst_cfg.type)
+				{
+				case 1:
+					srcProcess->getMemoryMap()->Read8(srcAddress + i, val8);
+					dstProcess->getMemoryMap()->Write8(dstAddress + (i % dmaConfig.dst_cfg.transfer_stride), val8);
+					i++;
+					break;
+				case 2:
+					srcProcess->getMemoryMap()->Read16(srcAddress + i, val16);
+					dstProcess->getMemoryMap()->Write16(dstAddress + (i % dmaConfig.dst_cfg.transfer_stride), val16);
+					i+=2;
+					break;
+				case 4:
+					srcProcess->getMemoryMap()->Read32(srcAddress + i, val32);
+					dstProcess->getMemoryMap()->Write32(dstAddress + (i % dmaConfig.dst_cfg.transfer_stride), val32);
+					i += 4;
+					break;
+				default:
+					LOG("error dmaConfig.dst_cfg.type 0x%02X not supported yet", dmaConfig.dst_cfg.type);
+					i++;
+					break;
+				}
 			}
 		}
 
@@ -1589,7 +1581,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = 0xD8E007F7;
 #ifdef SWILOG
-            LOG("Process %s thread %u StopDma failed (%08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle);
+            LOGDEBUG("Process %s thread %u StopDma failed (%08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle);
 #endif
             return;
         }
@@ -1597,7 +1589,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         Reg[0] = 0;
 
 #ifdef SWILOG
-        LOG("Process %s thread %u StopDma (%08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle);
+        LOGDEBUG("Process %s thread %u StopDma (%08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle);
 #endif
         return;
     }
@@ -1611,7 +1603,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = 0xD8E007F7;
 #ifdef SWILOG
-			LOG("Process %s thread %u GetDmaState failed (%08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle);
+			LOGDEBUG("Process %s thread %u GetDmaState failed (%08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle);
 #endif
 			return;
 		}
@@ -1620,7 +1612,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		Reg[1] = dmaObject->GetState();
 
 #ifdef SWILOG
-		LOG("Process %s thread %u GetDmaState (%08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[1]);
+		LOGDEBUG("Process %s thread %u GetDmaState (%08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handle, Reg[1]);
 #endif
 		return;
 	}
@@ -1651,7 +1643,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = 0xE0A01BF5;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
 #endif
 			return;
 		}
@@ -1659,7 +1651,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = 0xE0A01BF5;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
 #endif
 			return;
 		}
@@ -1667,7 +1659,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = 0xE0A01BF5;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
 #endif
 			return;
 		}
@@ -1681,7 +1673,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
 #endif
 			return;
 		}
@@ -1689,7 +1681,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		Reg[0] = 0;
 		Reg[1] = hand;
 #ifdef SWILOG
-		LOG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
+		LOGDEBUG("Process %s thread %u CreateCodeSet (%08x %08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, CodeSetInfo, code_ptr, ro_ptr, data_ptr, Reg[0], Reg[1]);
 #endif
 		return;
 	}
@@ -1706,7 +1698,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateProcess (%08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, codeset_handle, arm11kernelcaps_ptr, arm11kernelcaps_num, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateProcess (%08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, codeset_handle, arm11kernelcaps_ptr, arm11kernelcaps_num, Reg[0], Reg[1]);
 #endif
 			return;
 		}
@@ -1719,7 +1711,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		{
 			Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-			LOG("Process %s thread %u CreateProcess (%08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, codeset_handle, arm11kernelcaps_ptr, arm11kernelcaps_num, Reg[0], Reg[1]);
+			LOGDEBUG("Process %s thread %u CreateProcess (%08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, codeset_handle, arm11kernelcaps_ptr, arm11kernelcaps_num, Reg[0], Reg[1]);
 #endif
 			return;
 		}
@@ -1727,7 +1719,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 		Reg[0] = 0;
 		Reg[1] = hand;
 #ifdef SWILOG
-		LOG("Process %s thread %u CreateProcess (%08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, codeset_handle, arm11kernelcaps_ptr, arm11kernelcaps_num, Reg[0], Reg[1]);
+		LOGDEBUG("Process %s thread %u CreateProcess (%08x %08x %08x | %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, codeset_handle, arm11kernelcaps_ptr, arm11kernelcaps_num, Reg[0], Reg[1]);
 #endif
 		return;
 	}
@@ -1742,7 +1734,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u SetProcessResourceLimits (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handleResourceLimit, handleProcess, Reg[0]);
+            LOGDEBUG("Process %s thread %u SetProcessResourceLimits (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handleResourceLimit, handleProcess, Reg[0]);
 #endif
             return;
         }
@@ -1752,14 +1744,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u SetProcessResourceLimits (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handleResourceLimit, handleProcess, Reg[0]);
+            LOGDEBUG("Process %s thread %u SetProcessResourceLimits (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handleResourceLimit, handleProcess, Reg[0]);
 #endif
             return;
         }
         pr->SetResourceLimit(lim);
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u SetProcessResourceLimits (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handleResourceLimit, handleProcess, Reg[0]);
+        LOGDEBUG("Process %s thread %u SetProcessResourceLimits (%08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, handleResourceLimit, handleProcess, Reg[0]);
 #endif
         return;
     }
@@ -1772,14 +1764,14 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_CREATE_HANLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u CreateResourceLimit (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
+            LOGDEBUG("Process %s thread %u CreateResourceLimit (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
 #endif
             return;
         }
         Reg[0] = 0;
         Reg[1] = hand;
 #ifdef SWILOG
-        LOG("Process %s thread %u CreateResourceLimit (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
+        LOGDEBUG("Process %s thread %u CreateResourceLimit (| %08x %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, Reg[0], Reg[1]);
 #endif
         return;
     }
@@ -1794,7 +1786,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_POINTER;
 #ifdef SWILOG
-            LOG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1802,7 +1794,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_OUT_OF_RANGE;
 #ifdef SWILOG
-            LOG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1812,7 +1804,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         {
             Reg[0] = SVCERROR_INVALID_HANDLE;
 #ifdef SWILOG
-            LOG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+            LOGDEBUG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
             return;
         }
@@ -1827,7 +1819,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_INVALID_PARAMS;
 #ifdef SWILOG
-                LOG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+                LOGDEBUG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
                 return;
             }
@@ -1835,7 +1827,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_OUT_OF_RANGE;
 #ifdef SWILOG
-                LOG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+                LOGDEBUG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
                 return;
             }
@@ -1845,12 +1837,12 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             {
                 Reg[0] = SVCERROR_INVALID_PARAMS;
 #ifdef SWILOG
-                LOG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+                LOGDEBUG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
                 return;
             }
 #ifdef SWILOG
-            LOG("%08x -> %" PRIx64, data, value);
+            LOGDEBUG("%08x -> %" PRIx64, data, value);
 #endif
             lim->SetMaxValue(data, value);
 
@@ -1858,7 +1850,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
 
         Reg[0] = 0;
 #ifdef SWILOG
-        LOG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
+        LOGDEBUG("Process %s thread %u SetResourceLimitValues (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, values_ptr, handleResourceLimit, names_ptr, nameCount, Reg[0]);
 #endif
         return;
     }
@@ -1871,7 +1863,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
         if (type == 3 && param0 == 0) //map the firm laod param
         {
 
-            MemChunk* chunk = (MemChunk*)malloc(sizeof(MemChunk));
+            MemChunk* chunk = new MemChunk();
 
             chunk->size = 0x1000;
             chunk->data = currentThread->m_owner->m_Kernel->m_FIRM_Launch_Parameters;
@@ -1885,7 +1877,7 @@ void ProcessSwi(u8 swi, u32 Reg[15], KThread * currentThread)
             Reg[0] = -1;
         }
 #ifdef SWILOG
-        LOG("Process %s thread %u KernelSetState (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, type, param0, param1, param2, Reg[0]);
+        LOGDEBUG("Process %s thread %u KernelSetState (%08x %08x %08x %08x | %08x)", currentThread->m_owner->GetName(), currentThread->m_thread_id, type, param0, param1, param2, Reg[0]);
 #endif
         return;
     }
@@ -1,79 +1,76 @@
 #include "Kernel.h"
 
-KSynchronizationObject::KSynchronizationObject() : waiting(), m_killed(false)
+KSynchronizationObject::KSynchronizationObject() : m_killed(false), m_wait_first(NULL), m_wait_last(NULL)
 {
 
 }
 
 void KSynchronizationObject::SynFreeAll(u32 errorCode) {
 
-    while (waiting.list != NULL)
+    while (m_wait_first != NULL)
     {
-        KThread* thr = waiting.list->data;
-        thr->SyncFree(errorCode, this);
-        //waiting.RemoveItem(waiting.list);
+        KWaitBlock* block = m_wait_first;
+        SynRemove(block);
+        block->thread->SyncFree(errorCode, block);
     }
 }
 
 void KSynchronizationObject::SynFree(u32 errorCode, KThread* thread)
 {
-    KLinkedListNode<KThread>* current = waiting.list;
-    while (current != NULL)
-    {
-        if (current->data == thread)
-        {
-			KThread* thr = current->data;
-            waiting.RemoveItem(current);
-            thr->SyncFree(errorCode, this);
-        }
-        current = current->next;
-    }
+    // the thread is nearly always the first, SynGetNextPrio picked it
+    KWaitBlock* block = m_wait_first;
+    while (block != NULL && block->thread != thread)
+        block = block->next;
+    if (block == NULL)
+        return;
+    SynRemove(block);
+    thread->SyncFree(errorCode, block);
 }
-void KSynchronizationObject::SynRemove(KThread* thread)
+void KSynchronizationObject::SynRemove(KWaitBlock* block)
 {
-    KLinkedListNode<KThread>* current = waiting.list;
-    while (current != NULL)
-    {
-        if (current->data == thread)
-        {
-            KThread* thr = waiting.list->data;
-            waiting.RemoveItem(current);
-        }
-        current = current->next;
-    }
+    if (!block->queued)
+        return;
+
+    if (block->prev != NULL)
+        block->prev->next = block->next;
+    else
+        m_wait_first = block->next;
+
+    if (block->next != NULL)
+        block->next->prev = block->prev;
+    else
+        m_wait_last = block->prev;
+
+    block->next = NULL;
+    block->prev = NULL;
+    block->queued = false;
 }
 
-bool KSynchronizationObject::Syn(KThread* thread, u32 &error)
+bool KSynchronizationObject::Syn(KWaitBlock* block, u32 &error)
 {
-    waiting.AddItem(thread);
-    if (Synchronization(thread, error) == true)
-    {
-        return true;
-    }
+    // behind every thread of the same or a better priority, mostly that is the end
+    s32 prio = block->thread->m_thread_prio;
+    KWaitBlock* prev = m_wait_last;
+    while (prev != NULL && prev->thread->m_thread_prio > prio)
+        prev = prev->prev;
+
+    block->prev = prev;
+    block->next = prev != NULL ? prev->next : m_wait_first;
+    if (block->next != NULL)
+        block->next->prev = block;
     else
-    {
-        return false;
-    }
+        m_wait_last = block;
+    if (prev != NULL)
+        prev->next = block;
+    else
+        m_wait_first = block;
+    block->queued = true;
+
+    return Synchronization(block->thread, error);
 }
-KThread* KSynchronizationObject::SynGetNextPrio() //the threads have 2 prioritys don't know what the different is we only use one here so TODO change that also what happens when 2 have the same prio
+KThread* KSynchronizationObject::SynGetNextPrio()
 {
-    KThread* found = NULL;
-    KLinkedListNode<KThread>* current = waiting.list;
-    while (current)
-    {
-        KThread* thr = waiting.list->data;
-        if (found)
-        {
-            if (found->m_thread_prio < thr->m_thread_prio)
-                found = thr;
-        }
-        else
-        {
-            found = thr;
-        }
-        current = current->next;
-    }
-    return found;
+    return m_wait_first != NULL ? m_wait_first->thread : NULL;
 }
 
 bool KSynchronizationObject::IsInstanceOf(ClassName name) {
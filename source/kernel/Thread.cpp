@@ -13,23 +13,27 @@ KThread::KThread(s32 core, KProcess *owner) : m_running(true)
 
     m_thread_id = owner->m_Kernel->GetNextThreadID();
 
-    Threadwaitlist = NULL;
+    m_waitAll = false;
+    m_wait_left = 0;
+    m_wait_count = 0;
+    m_ipc_session = NULL;
     m_corenumb = core;
+
+    m_thread_prio = 0x30;
+    m_prev = NULL;
+    m_next = NULL;
+    m_queued_prio = 0;
+    m_started = false;
+    m_ready = false;
 }
 void KThread::stop()
 {
 	SynFreeAll(0);
 	m_running = false;
+	m_owner->m_Kernel->UpdateReadyState(this);
 }
 void KThread::trigger_event()
 {
-	KLinkedListNode<KTimeedEvent> *t = m_owner->m_Kernel->m_Timedevent.list;
-	while (t)
-	{
-		if (t->data == this)
-			m_owner->m_Kernel->m_Timedevent.RemoveItem(t);
-		t = t->next;
-	}
 	SynFree(0, this);//the system is waiting for itself so free it
 }
 bool KThread::IsInstanceOf(ClassName name) {
@@ -48,131 +52,76 @@ bool KThread::Synchronization(KThread* thread, u32 &error)
 	return m_running;
 }
 
-void KThread::SyncStall(KLinkedList<KSynchronizationObject>* objects, bool waitAll) //todo stop if a error happen
+void KThread::SetWaitResult(s32 errorCode, s32 index, bool has_index)
 {
-    if (objects->list)
+    //this must search for the core
+    if (m_core)
     {
-        int sorce = 0; //check if the obj is not desolate
-        KLinkedListNode<KSynchronizationObject>* current = objects->list;// get the last
-        while (current->next != NULL)
-        {
-            current = current->next;
-        }
-		while (current != NULL) //check if this is correct but it looks like it is TODO
-		{
-			if (current->data->m_killed == true)
-			{
-				//this must search for the core
-				if (m_core)
-				{
-					m_core->SetRegister(1, sorce);
-					m_core->SetRegister(0, 0xC920181A); //error closed
-					return;
-				}
-				else
-				{
-					m_context.cpu_registers[1] = sorce;
-					m_context.cpu_registers[0] = 0xC920181A; //error closed
-				}
-			}
-			sorce++;
-			current = current->prev;
-		}
-		
-		m_waitAll = waitAll;
-        m_owner->m_Kernel->ReScheduler();
-
-        if (Threadwaitlist)
+        if (has_index)
+            m_core->SetRegister(1, index);
+        m_core->SetRegister(0, errorCode);
+    }
+    else
+    {
+        if (has_index)
+            m_context.cpu_registers[1] = index;
+        m_context.cpu_registers[0] = errorCode;
+    }
+}
+void KThread::SyncStall(KSynchronizationObject** objects, u32 count, bool waitAll) //todo stop if a error happen
+{
+    if (count == 0)
+        return;
+
+    for (u32 i = 0; i < count; i++) //check if the obj is not desolate
+    {
+        if (objects[i]->m_killed)
         {
-            delete Threadwaitlist;
-            Threadwaitlist = NULL;
+            SetWaitResult(0xC920181A, i, true); //error closed
+            return;
         }
-        Threadwaitlist = objects;
+    }
 
-        KLinkedList<KSynchronizationObject> free;
+    m_waitAll = waitAll;
+    m_owner->m_Kernel->ReScheduler();
 
+    m_wait_left = waitAll ? count : 1;
+    m_wait_count = 0;
+    for (u32 i = 0; i < count && m_wait_left; i++)
+    {
+        KWaitBlock* block = &m_wait_blocks[i];
+        block->thread = this;
+        block->object = objects[i];
+        block->index = i;
+        m_wait_count++;
 
         u32 errorCode = 0;
-		//check for 0
-
-		current = objects->list;
-		while (current->next != NULL)
-		{
-			current = current->next;
-		}
-        while (current != NULL) //check if this is correct but it looks like it is TODO
-        {
-            bool locked = current->data->Syn(this, errorCode);
-            if (!locked)
-            {
-                free.AddItem(current->data);
-                if (!waitAll)
-                    break;
-            }
-            current = current->prev;
-        }
-        while (free.list)
+        bool locked = objects[i]->Syn(block, errorCode);
+        if (!locked && block->queued) // free at once, unless Synchronization woke the thread already
         {
-            free.list->data->SynFree(errorCode, this);
-            free.RemoveItem(free.list);
+            objects[i]->SynRemove(block);
+            SyncFree(errorCode, block);
         }
     }
-
+    m_owner->m_Kernel->UpdateReadyState(this);
 }
-void KThread::SyncFree(s32 errorCode, KSynchronizationObject* obj)
+void KThread::SyncFree(s32 errorCode, KWaitBlock* block)
 {
+    if (m_wait_left == 0) //only if the thread is waiting
+        return;
 
-    //find src
-    u32 sorce = 0;
+    if (m_waitAll && !errorCode && --m_wait_left)
+        return;
 
-    KLinkedListNode<KSynchronizationObject>* current;// get the last
-    if (Threadwaitlist->list) //only if the thread is waiting
+    // the wait is over, the thread leaves the queues it is still in
+    for (u32 i = 0; i < m_wait_count; i++)
     {
-        current = Threadwaitlist->list;
-        bool found = false;
-
-        while (current->prev != NULL)
-        {
-            current = current->prev;
-        }
-
-        while (current != NULL)
-        {
-            if (found)
-                sorce++;
-            if (current->data == obj)
-                found = true;
-
-            if (m_waitAll)
-                Threadwaitlist->RemoveItem(current);
-            current = current->next;
-        }
-
-        if (!m_waitAll)
-        {
-            while (Threadwaitlist->list != NULL)
-            {
-                Threadwaitlist->list->data->SynRemove(this);
-                Threadwaitlist->RemoveItem(Threadwaitlist->list);
-            }
-        }
-        if (!Threadwaitlist->list || errorCode) //check if the error code stuff is correct TODO
-        {
-            //this must search for the core
-            if (m_core)
-            {
-                if (errorCode || !m_waitAll)
-                    m_core->SetRegister(1,sorce);
-                m_core->SetRegister(0, errorCode);
-            }
-            else
-            {
-                if (errorCode || !m_waitAll)
-                    m_context.cpu_registers[1] = sorce;
-                m_context.cpu_registers[0] = errorCode;
-            }
-			LOG("free %s thread %d %08x %08x", m_owner->GetName(), m_thread_id, errorCode, sorce);
-            //todo speek to Scheduler here
-        }
+        if (m_wait_blocks[i].queued)
+            m_wait_blocks[i].object->SynRemove(&m_wait_blocks[i]);
     }
-}
\ No newline at end of file
+    m_wait_left = 0;
+
+    SetWaitResult(errorCode, block->index, errorCode || !m_waitAll);
+    LOG("free %s thread %d %08x %08x", m_owner->GetName(), m_thread_id, errorCode, block->index);
+    m_owner->m_Kernel->UpdateReadyState(this);
+}
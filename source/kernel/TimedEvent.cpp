@@ -0,0 +1,90 @@
+#include "Kernel.h"
+
+void KTimedEventQueue::Place(u32 i, KTimeedEvent* eve)
+{
+	m_heap[i] = eve;
+	eve->m_queue_index = i;
+}
+
+void KTimedEventQueue::SiftUp(u32 i)
+{
+	KTimeedEvent* eve = m_heap[i];
+	while (i > 0)
+	{
+		u32 parent = (i - 1) / 2;
+		if (m_heap[parent]->m_deadline <= eve->m_deadline)
+			break;
+		Place(i, m_heap[parent]);
+		i = parent;
+	}
+	Place(i, eve);
+}
+
+void KTimedEventQueue::SiftDown(u32 i)
+{
+	KTimeedEvent* eve = m_heap[i];
+	u32 size = m_heap.size();
+	while (true)
+	{
+		u32 child = i * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && m_heap[child + 1]->m_deadline < m_heap[child]->m_deadline)
+			child++;
+		if (eve->m_deadline <= m_heap[child]->m_deadline)
+			break;
+		Place(i, m_heap[child]);
+		i = child;
+	}
+	Place(i, eve);
+}
+
+void KTimedEventQueue::Schedule(KTimeedEvent* eve, u64 deadline)
+{
+	if (eve->m_queue_index < 0)
+	{
+		eve->m_deadline = deadline;
+		m_heap.push_back(eve);
+		SiftUp(m_heap.size() - 1);
+		return;
+	}
+	u64 old = eve->m_deadline;
+	eve->m_deadline = deadline;
+	if (deadline < old)
+		SiftUp(eve->m_queue_index);
+	else
+		SiftDown(eve->m_queue_index);
+}
+
+void KTimedEventQueue::Cancel(KTimeedEvent* eve)
+{
+	if (eve->m_queue_index < 0)
+		return;
+	u32 i = eve->m_queue_index;
+	KTimeedEvent* last = m_heap.back();
+	m_heap.pop_back();
+	eve->m_queue_index = -1;
+	if (last == eve)
+		return;
+
+	// the last event takes the free place and moves whichever way its deadline needs
+	Place(i, last);
+	if (i > 0 && last->m_deadline < m_heap[(i - 1) / 2]->m_deadline)
+		SiftUp(i);
+	else
+		SiftDown(i);
+}
+
+u64 KTimedEventQueue::NextDeadline() const
+{
+	return m_heap.empty() ? ~(u64)0 : m_heap[0]->m_deadline;
+}
+
+KTimeedEvent* KTimedEventQueue::PopDue(u64 now)
+{
+	if (m_heap.empty() || m_heap[0]->m_deadline > now)
+		return NULL;
+	KTimeedEvent* eve = m_heap[0];
+	Cancel(eve);
+	return eve;
+}
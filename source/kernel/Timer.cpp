@@ -4,18 +4,10 @@
 
 KTimer::KTimer(KProcess *owner, u32 resettype) : m_ResetType(resettype), m_owner(owner), m_Enabled(false), m_locked(true)
 {
-	m_owner->m_Kernel->m_Timedevent.AddItem(this);
 }
 KTimer::~KTimer()
 {
-	KLinkedListNode<KTimeedEvent> *t = m_owner->m_Kernel->m_Timedevent.list;
-	while (t)
-	{
-		if (t->data == this)
-			m_owner->m_Kernel->m_Timedevent.RemoveItem(t);
-		t = t->next;
-	}
-	
+	m_owner->m_Kernel->CancelTimeEvent(this);
 }
 void KTimer::trigger_event()
 {
@@ -26,20 +18,20 @@ void KTimer::trigger_event()
 	else
 		if (m_ResetType != 2) //pulse
 			m_locked = false;
-	m_owner->m_Kernel->FireNextTimeEvent(this, m_Interval);
+	m_owner->m_Kernel->FireNextTimeEvent(this, KKernel::NanosecondsToTicks(m_Interval));
 }
 Result KTimer::SetTimer(s64 initial, s64 interval)
 {
 	m_Enabled = true;
 	m_Initial = initial;
 	m_Interval = interval;
-	m_owner->m_Kernel->FireNextTimeEvent(this, m_Initial + 1);
+	m_owner->m_Kernel->FireNextTimeEvent(this, KKernel::NanosecondsToTicks(m_Initial) + 1);
 	return Success;
 }
 void KTimer::Cancel()
 {
 	m_Enabled = false;
-	num_cycles_remaining = 0;
+	m_owner->m_Kernel->CancelTimeEvent(this);
 }
 bool KTimer::Synchronization(KThread* thread, u32 &error)
 {
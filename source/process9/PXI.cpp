@@ -1,14 +1,21 @@
+#define LOG_CLASS LOGCLASS_P9
+
 #include "Kernel.h"
 #include "Hardware.h"
 #include "Process9.h"
 
+// requests that come through the FIFO, at debug level
+#if LOG_MIN_LEVEL <= LOGLEVEL_DEBUG
 #define LOGP9COM
+#endif
 
 Process9::Process9(KKernel* kernel) :HWIPC(kernel), m_FS(this), m_PM(this), m_PS(this), m_MC(this), m_AM(this)
 {
     m_IPCSYNCP9 = 1; // init step
     m_IntiHadData = false;
     m_datarecved = 0;
+    m_hle = false;
+    m_hle_reply = NULL;
 }
 Process9::~Process9()
 {
@@ -67,54 +74,107 @@ void Process9::FIFOWriteBackCall()
             {
 #ifdef LOGP9COM
                 for (u32 i = 1; i < m_datarecved; i++)
-                    LOG("recv: %08x", m_datarecv[i]);
+                    LOGDEBUG("recv: %08x", m_datarecv[i]);
 #endif
-                switch (m_datarecv[0])
-                {
-				case 0:
-					m_MC.Command(&m_datarecv[1], m_datarecv[0]);
-					break;
-                case 1:
+                LearnChannel();
+                Dispatch(m_datarecv);
+
+                m_datarecved = 0;
+            }
+        }
+    }
+}
+void Process9::Dispatch(u32 data[])
+{
+    switch (data[0])
+    {
+	case 0:
+		m_MC.Command(&data[1], data[0]);
+		break;
+    case 1:
+#ifdef LOGP9COM
+        LOGDEBUG("P9 FS0");
+#endif
+		m_FS.Command(&data[1], data[0]);
+        break;
+    case 2:
 #ifdef LOGP9COM
-                    LOG("P9 FS0");
+        LOGDEBUG("P9 FS1");
 #endif
-					m_FS.Command(&m_datarecv[1], m_datarecv[0]);
-                    break;
-                case 2:
+		m_FS.Command(&data[1], data[0]);
+        break;
+    case 3:
 #ifdef LOGP9COM
-                    LOG("P9 FS1");
+        LOGDEBUG("P9 FS2");
 #endif
-					m_FS.Command(&m_datarecv[1], m_datarecv[0]);
-                    break;
-                case 3:
+		m_FS.Command(&data[1], data[0]);
+        break;
+    case 4:
 #ifdef LOGP9COM
-                    LOG("P9 FS2");
+        LOGDEBUG("P9 FS3");
 #endif
-					m_FS.Command(&m_datarecv[1], m_datarecv[0]);
-                    break;
-                case 4:
+		m_FS.Command(&data[1], data[0]);
+        break;
+    case 5:
+		m_PM.Command(&data[1], data[0]);
+        break;
+	case 7:
+		m_AM.Command(&data[1], data[0]);
+		break;
+	case 8:
+		m_PS.Command(&data[1], data[0]);
+		break;
+    default:
+        LOG("P9 data to unknown %08x", data[0]);
+    }
+}
+void Process9::LearnChannel()
+{
+    // pxi passed a request on, if it did so unchanged the session can skip pxi from now on
+    KThread* thread = m_kernel->GetCurrentThread();
+    if (thread == NULL || thread->m_ipc_session == NULL || thread->m_ipc_session->m_p9_channel >= 0)
+        return;
+    if (memcmp(&m_datarecv[1], thread->m_TSLpointer + 0x80, (m_datarecved - 1) * sizeof(u32)) != 0)
+        return;
+    thread->m_ipc_session->m_p9_channel = m_datarecv[0];
 #ifdef LOGP9COM
-                    LOG("P9 FS3");
+    LOGDEBUG("P9 channel %u learned from %s", m_datarecv[0], thread->m_owner->GetName());
 #endif
-					m_FS.Command(&m_datarecv[1], m_datarecv[0]);
-                    break;
-                case 5:
-					m_PM.Command(&m_datarecv[1], m_datarecv[0]);
-                    break;
-				case 7:
-					m_AM.Command(&m_datarecv[1], m_datarecv[0]);
-					break;
-				case 8:
-					m_PS.Command(&m_datarecv[1], m_datarecv[0]);
-					break;
-                default:
-                    LOG("P9 data to unknown %08x", m_datarecv[0]);
-                }
+}
+void Process9::SetHLE(bool hle)
+{
+    m_hle = hle;
+}
+bool Process9::IsHLE()
+{
+    return m_hle;
+}
+bool Process9::HLERequest(u32 channel, KThread* client)
+{
+    u32* cmdbuf = (u32*)(client->m_TSLpointer + 0x80);
+    u32 translated = cmdbuf[0] & 0x3F;
+    u32 nomal = (cmdbuf[0] >> 6) & 0x3F;
+    u32 size = 1 + nomal + translated;
+    if (size > IPC_MAX_WORDS)
+        return false;
 
-                m_datarecved = 0;
-            }
-        }
+    // only PXI buffers are passed on, their addresses stay in the address space of the client
+    for (u32 i = 1 + nomal; i < size; i += 2)
+    {
+        u32 descriptor = cmdbuf[i];
+        if ((descriptor & 0xF) != 0x4 && (descriptor & 0xF) != 0x6)
+            return false;
+        m_kernel->m_IPCFIFOAdresses[(descriptor >> 4) & 0xF] = client->m_owner->getMemoryMap();
+        m_kernel->m_IPCFIFOAdressesRO[(descriptor >> 4) & 0xF] = (descriptor & 0xF) == 0x6;
     }
+
+    u32 data[1 + IPC_MAX_WORDS];
+    data[0] = channel;
+    memcpy(&data[1], cmdbuf, size * sizeof(u32));
+    m_hle_reply = cmdbuf;
+    Dispatch(data);
+    m_hle_reply = NULL;
+    return true;
 }
 void Process9::FIFOIRQ()
 {
@@ -129,6 +189,16 @@ void Process9::Sendresponds(u32 myid, u32 data[])
     u32 translated = data[0] & 0x3F;
     u32 nomal = (data[0] >> 6) & 0x3F;
     u32 size = translated + nomal;
+    if (m_hle_reply)
+    {
+        if (size + 1 > IPC_MAX_WORDS)
+        {
+            XDSERROR("P9 reply %08x does not fit in the command buffer", data[0]);
+            size = IPC_MAX_WORDS - 1;
+        }
+        memcpy(m_hle_reply, data, (size + 1) * sizeof(u32));
+        return;
+    }
     m_datasended = 0;
     m_datasend[0] = myid;
 
@@ -38,18 +38,11 @@ void P9AM::Command(u32 data[], u32 numb)
 		LOG("GetTitleInfo %02x %08x", medid, count);
 		for (int j = 0; j < count; j++)
 		{
-			u8 temp = 0;
-			for (u32 i = 0; i < 8; i++) // copy id
-			{
-				m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->Read8(i + ptr_read, temp);
-				printf("%02x", temp);
-				m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Write8(i + ptr_write, temp);
-			}
-			for (u32 i = 8; i < 24; i++)
-			{
-				m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Write8(i + ptr_write, 0);
-			}
-			LOG("");
+			u8 id[8] = { 0 };
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->ReadN(ptr_read, id, 8);
+			LOGHEX(id, 8);
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->WriteN(ptr_write, id, 8); // copy id
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Fill(ptr_write + 8, 0, 16);
 			ptr_write += 24;
 		}
 
@@ -68,18 +61,11 @@ void P9AM::Command(u32 data[], u32 numb)
 		LOG("GetTitleTemporaryInfo %08x %08x", unk, count);
 		for (int j = 0; j < count; j++)
 		{
-			u8 temp = 0;
-			for (u32 i = 0; i < 8; i++) // copy id
-			{
-				m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->Read8(i + ptr_read, temp);
-				printf("%02x", temp);
-				m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Write8(i + ptr_write, temp);
-			}
-			for (u32 i = 8; i < 24; i++)
-			{
-				m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Write8(i + ptr_write, 0);
-			}
-			LOG("");
+			u8 id[8] = { 0 };
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->ReadN(ptr_read, id, 8);
+			LOGHEX(id, 8);
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->WriteN(ptr_write, id, 8); // copy id
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Fill(ptr_write + 8, 0, 16);
 			ptr_write += 24;
 		}
 
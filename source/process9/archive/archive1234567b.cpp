@@ -39,8 +39,6 @@ P9File* Archive1234567b::OpenFile(LowPath* lowpath, u32 flags, u32 attributes, u
 	u64 size = ftell64(fd);
 	fseek64(fd, 0, SEEK_SET);
 
-	u8 *hash = new u8[0x20];
-	memset(hash, 0, 0x20); //TODO: Implement SHA256 hashing
-	P9File * f = new P9File(m_owner, m_lowpath, *lowpath, fd, 0, size, hash, 0x1234567b);
+	P9File * f = new P9File(m_owner, m_lowpath, *lowpath, fd, 0, size, NULL, 0x1234567b); // hashed when asked for
 	return f;
 }
\ No newline at end of file
@@ -3,8 +3,6 @@
 #include "Process9.h"
 #include "process9/archive.h"
 
-extern FILE* openapp(u32 titlehigh, u32 titlelow); //this is from Bootloader.cpp
-extern s64 FindTableOffset(FILE* fd, char* name, u64 &out_size, u8* hash_out);
 
 Archive1234567c::Archive1234567c(Process9* owner, LowPath *lowpath) : Archive(owner, lowpath)
 {
@@ -26,9 +24,7 @@ P9File* Archive1234567c::OpenFile(LowPath* lowpath, u32 flags, u32 attributes, u
 	u64 size = ftell64(fd);
 	fseek64(fd, 0, SEEK_SET);
 
-	u8 *hash = new u8[0x20];
-	memset(hash, 0, 0x20); //TODO: Implement SHA256 hashing
-	P9File * f = new P9File(m_owner, m_lowpath, *lowpath, fd, 0, size, hash, 0x1234567c);
+	P9File * f = new P9File(m_owner, m_lowpath, *lowpath, fd, 0, size, NULL, 0x1234567c); // hashed when asked for
 	return f;
 }
 
@@ -2,10 +2,7 @@
 #include "Hardware.h"
 #include "Process9.h"
 #include "process9/archive.h"
-
-extern FILE* openapp(u32 titlehigh, u32 titlelow); //this is from Bootloader.cpp
-extern s64 FindTableOffset(FILE* fd, char* name, u64 &out_size, u8* hash_out);
-extern s64 FindRomFSOffset(FILE* fd, char* name, u64 &out_size, u8* hash_out);
+#include "Bootloader.h"
 
 #define strcpy_s(a,b,c) strncpy(a,c,b)
 
@@ -17,26 +14,51 @@ P9File* Archive2345678e::OpenFile(LowPath* lowpath, u32 flags, u32 attributes, u
 {
 	char path[9];
 	strcpy_s(path,8, (char*)lowpath->getraw() + 4);
+	path[8] = '\0';
 	LOG("   path: type = %08x, str = %s", *(u32*)lowpath->getraw(), path);
-	FILE * fd = openapp(m_title >> 32, (u32)m_title);
-	u64 size;
-	u8 *hash = new u8[0x20];
-	s64 offset;
+	const NcchContainer* container;
+	FILE * fd = openapp(m_title >> 32, (u32)m_title, container);
+	if (!fd)
+		return NULL;
+	u64 offset = 0;
+	u64 size = 0;
+	bool found = false;
+	u8 *hash = NULL;
 	switch (*(u32*)lowpath->getraw())
 	{
 	case 0:
-		offset = FindRomFSOffset(fd, path, size, hash);
+		if (!container)
+			break;
+		offset = container->romfs_offset;
+		size = container->romfs_size;
+		found = true;
 		break;
 	case 1:
-		offset = FindTableOffset(fd, path, size, hash);
+	{
+		const ncch_section* section = container ? container->FindSection(path) : NULL;
+		if (!section)
+			break;
+		offset = section->offset;
+		size = section->size;
+		// the ExeFS header has the hashes of its sections
+		hash = new u8[0x20];
+		memcpy(hash, section->hash, 0x20);
+		found = true;
 		break;
+	}
 	default:
 		LOG("error unknown src");
-		for (u32 i = 0; i < lowpath->GetSize(); i++)
-			printf("%02x", lowpath->getraw()[i]);
-		LOG("");
+		LOGHEX(lowpath->getraw(), lowpath->GetSize());
+		break;
+	}
+	if (!found)
+	{
+		fclose(fd);
 		return NULL;
 	}
 	P9File * f = new P9File(m_owner, m_lowpath, *lowpath, fd, offset, size, hash, 0x2345678e);
+	f->MapRead();
+	if (hash == NULL)
+		f->SetContentPath(container->path.c_str());
 	return f;
 }
@@ -5,34 +5,85 @@
 #include "Process9.h"
 #include "process9/archive.h"
 
-P9File::P9File(Process9* owner, LowPath lowpath, LowPath highpath, u32 achivetype) : m_owner(owner), m_lowpath(lowpath), m_highpath(highpath), m_achivetype(achivetype)
+P9File::P9File(Process9* owner, LowPath lowpath, LowPath highpath, u32 achivetype) : m_lowpath(lowpath), m_highpath(highpath), m_offset(0), m_size(0), m_owner(owner), m_fs(NULL), m_hash(NULL), m_achivetype(achivetype), m_mapped(false)
 {
-
+	m_realpath[0] = '\0';
 }
-P9File::P9File(Process9* owner, LowPath lowpath, LowPath highpath, FILE* fs, u64 offset, u64 size, u8* hash, u32 achivetype) : m_owner(owner), m_lowpath(lowpath), m_highpath(highpath), m_fs(fs), m_offset(offset), m_size(size), m_hash(hash), m_achivetype(achivetype)
+P9File::P9File(Process9* owner, LowPath lowpath, LowPath highpath, FILE* fs, u64 offset, u64 size, u8* hash, u32 achivetype) : m_lowpath(lowpath), m_highpath(highpath), m_offset(offset), m_size(size), m_owner(owner), m_fs(fs), m_hash(hash), m_achivetype(achivetype), m_mapped(false)
 {
-
+	m_realpath[0] = '\0';
 }
 P9File::~P9File() {
-	delete m_hash;
+	delete[] m_hash;
+	if (m_mapped)
+		Common::UnmapFileView(&m_view);
 	if (m_fs)
 		fclose(m_fs);
 }
 
+bool P9File::MapRead()
+{
+	if (!m_mapped && m_fs)
+		m_mapped = Common::MapFileView(m_fs, m_offset, m_size, &m_view);
+	return m_mapped;
+}
+
 u64 P9File::getsize()
 {
 	return m_size;
 }
 
+void P9File::SetContentPath(const char* path)
+{
+	strncpy(m_realpath, path, sizeof(m_realpath) - 1);
+	m_realpath[sizeof(m_realpath) - 1] = '\0';
+	P9HashCache::Prefetch(m_realpath, m_offset, m_size);
+}
+
 u8* P9File::GetHashPtr()
 {
+	if (m_hash)
+		return m_hash;
+	m_hash = new u8[0x20];
+	if (m_realpath[0] != '\0')
+	{
+		if (!P9HashCache::Get(m_realpath, m_offset, m_size, m_hash))
+			memset(m_hash, 0, 0x20);
+		return m_hash;
+	}
+
+	// files that are written to are hashed as they are right now, write drops the hash
+	Common::Sha256 sha;
+	u8* buffer = new u8[0x10000];
+	for (u64 done = 0; done < m_size;)
+	{
+		u32 part = m_size - done < 0x10000 ? (u32)(m_size - done) : 0x10000;
+		u32 read;
+		this->read(buffer, part, done, read);
+		if (read == 0)
+			break;
+		sha.Update(buffer, read);
+		done += read;
+	}
+	delete[] buffer;
+	sha.Final(m_hash);
 	return m_hash;
 }
 
 s32 P9File::read(u8 *buffer,u32 size,u64 file_offset,u32 &out_sizeread)
 {
-	fseek64(m_fs, file_offset + m_offset, SEEK_SET);
-	out_sizeread = fread(buffer, 1, size, m_fs);
+	if (m_mapped)
+	{
+		// a mapped container ends at m_size, what lies behind it belongs to something else
+		u64 left = file_offset < m_size ? m_size - file_offset : 0;
+		out_sizeread = size < left ? size : (u32)left;
+		memcpy(buffer, m_view.data + file_offset, out_sizeread);
+	}
+	else
+	{
+		s64 ret = Common::ReadFileAt(m_fs, buffer, size, file_offset + m_offset);
+		out_sizeread = ret < 0 ? 0 : (u32)ret;
+	}
 	if ((m_achivetype == 0x1234567c || m_achivetype == 0x1234567b) && file_offset == 0 && size >= 0x100) //MAC AESEnginePatch
 	{
 		memset(buffer, 0x11, 0x100);
@@ -42,14 +93,20 @@ s32 P9File::read(u8 *buffer,u32 size,u64 file_offset,u32 &out_sizeread)
 
 s32 P9File::write(u8 *buffer, u32 size, u64 file_offset, u32 &out_sizewritten)
 {
-	fseek64(m_fs, file_offset + m_offset, SEEK_SET);
-	out_sizewritten = fwrite(buffer, 1, size, m_fs);
-	fflush(m_fs);
+	// the write goes to the OS right away, there is no stdio buffer left to flush
+	s64 ret = Common::WriteFileAt(m_fs, buffer, size, file_offset + m_offset);
+	out_sizewritten = ret < 0 ? 0 : (u32)ret;
+	if (file_offset + out_sizewritten > m_size)
+		m_size = file_offset + out_sizewritten;
+	delete[] m_hash;
+	m_hash = NULL;
 	return 0;
 }
 s32 P9File::setsize(u64 size)
 {
 	m_size = size;
+	delete[] m_hash;
+	m_hash = NULL;
 	if (ftruncate(fileno(m_fs), size) == -1) {
 		LOG("ftruncate failed.\n");
 		return -1;
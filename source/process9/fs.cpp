@@ -1,9 +1,14 @@
+#define LOG_CLASS LOGCLASS_FS
+
 #include "Kernel.h"
 #include "Hardware.h"
 #include "Process9.h"
 #include "process9/archive.h"
 
+// FS requests at debug level
+#if LOG_MIN_LEVEL <= LOGLEVEL_DEBUG
 #define LOGFS
+#endif
 
 P9FS::P9FS(Process9* owner) : m_owner(owner)
 {
@@ -11,6 +16,16 @@ P9FS::P9FS(Process9* owner) : m_owner(owner)
 P9FS::~P9FS()
 {
 
+}
+Archive* P9FS::FindArchive(u64 handle)
+{
+	auto it = m_archives.find(handle);
+	return it != m_archives.end() ? it->second : NULL;
+}
+P9File* P9FS::FindFile(u64 handle)
+{
+	auto it = m_files.find(handle);
+	return it != m_files.end() ? it->second : NULL;
 }
 void P9FS::Command(u32 data[], u32 numb)
 {
@@ -34,46 +49,33 @@ void P9FS::Command(u32 data[], u32 numb)
 
 #ifdef LOGFS
 		char tmp[256];
-		LOG("FS OpenFile");
-		LOG("   archive_handle=%" PRIx64, handle);
-		LOG("   flags = %s", P9File::FlagsToString(flags, tmp));
+		LOGDEBUG("FS OpenFile");
+		LOGDEBUG("   archive_handle=%" PRIx64, handle);
+		LOGDEBUG("   flags = %s", P9File::FlagsToString(flags, tmp));
 #endif
 
-		auto a = m_open.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
+		Archive* archive = FindArchive(handle);
 
 		u64 p9file_handle = 0;
 		P9File* P9file = 0;
 		u32 result = 0xc8804464; //TODO: Find proper error code
 
-		if (a)
+		if (archive)
 		{
 			//This is freed in the destructor of LowPath
 			u8 *lowpath_data = new u8[file_lowpath_sz];
-			for (u32 i = 0; i < file_lowpath_sz; i++)
-			{
-				u8 sdata = 0;
-				s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(file_lowpath_desc >> 4) & 0xF]->Read8(i + file_lowpath_ptr, sdata);
-				lowpath_data[i] = sdata;
-			}
+			memset(lowpath_data, 0, file_lowpath_sz);
+			m_owner->m_kernel->m_IPCFIFOAdresses[(file_lowpath_desc >> 4) & 0xF]->ReadN(file_lowpath_ptr, lowpath_data, file_lowpath_sz);
 
 			LowPath lowpath(file_lowpath_type, file_lowpath_sz, file_lowpath_desc, lowpath_data);
-			P9file = a->data->Archobj->OpenFile(&lowpath, flags, attr, &result);
+			P9file = archive->OpenFile(&lowpath, flags, attr, &result);
 			/*delete lowpath_data;
 			delete lowpath;*/ //todo fix me plz
 		}
 		if (P9file)
 		{
-			s_fsFileentry *a = new s_fsFileentry;
-			a->id = lastID++;
-			p9file_handle = a->id;
-			a->Archobj = P9file;
-			m_fopen.AddItem(a);
+			p9file_handle = lastID++;
+			m_files[p9file_handle] = P9file;
 			result = 0;
 		}
 		else
@@ -82,7 +84,7 @@ void P9FS::Command(u32 data[], u32 numb)
 		}
 
 #ifdef LOGFS
-		LOG("   p9file_handle=%" PRIx64, p9file_handle);
+		LOGDEBUG("   p9file_handle=%" PRIx64, p9file_handle);
 #endif
 
 		resdata[0] = 0x000100C1;
@@ -102,36 +104,26 @@ void P9FS::Command(u32 data[], u32 numb)
 		u32 file_lowpath_ptr = data[7];
 
 #ifdef LOGFS
-		LOG("FS DeleteFile");
-		LOG("   archive_handle=%" PRIx64, handle);
+		LOGDEBUG("FS DeleteFile");
+		LOGDEBUG("   archive_handle=%" PRIx64, handle);
 #endif
 
 		resdata[0] = 0x00020142;
 		resdata[1] = 0xFFFFFFFF; //todo get the correct error
 
-		auto a = m_open.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
+		Archive* archive = FindArchive(handle);
 
-		if (a)
+		if (archive)
 		{
 			//This is freed in the destructor of LowPath
 			u8 *lowpath_data = new u8[file_lowpath_sz];
-			for (u32 i = 0; i < file_lowpath_sz; i++)
-			{
-				u8 sdata = 0;
-				s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(file_lowpath_desc >> 4) & 0xF]->Read8(i + file_lowpath_ptr, sdata);
-				lowpath_data[i] = sdata;
-			}
+			memset(lowpath_data, 0, file_lowpath_sz);
+			m_owner->m_kernel->m_IPCFIFOAdresses[(file_lowpath_desc >> 4) & 0xF]->ReadN(file_lowpath_ptr, lowpath_data, file_lowpath_sz);
 
 			auto lowpath = new LowPath(file_lowpath_type, file_lowpath_sz, file_lowpath_desc, lowpath_data);
 
 			u32 result = 0;
-			a->data->Archobj->DeleteFile(lowpath, &result);
+			archive->DeleteFile(lowpath, &result);
 			delete lowpath;
 
 			if (result == -1)
@@ -151,9 +143,9 @@ void P9FS::Command(u32 data[], u32 numb)
 		u32 ptr_read = data[7];
 
 #ifdef LOGFS
-		LOG("FS ReadFile %08x %08x %08x", size, desc_read, ptr_read);
-		LOG("   file_handle=%" PRIx64, handle);
-		LOG("   file_offset=%" PRIx64, file_offset);
+		LOGDEBUG("FS ReadFile %08x %08x %08x", size, desc_read, ptr_read);
+		LOGDEBUG("   file_handle=%" PRIx64, handle);
+		LOGDEBUG("   file_offset=%" PRIx64, file_offset);
 #endif
 		resdata[0] = 0x00090142;
 		resdata[1] = 0xFFFFFFFF; //todo get the correct error
@@ -162,28 +154,20 @@ void P9FS::Command(u32 data[], u32 numb)
 		u8 *buffer = new u8[buffsize];
 		memset(buffer, 0, buffsize);
 
-		auto a = m_fopen.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
 			u32 out_size = 0;
-			a->data->Archobj->read(buffer, size, file_offset, out_size);
+			file->read(buffer, size, file_offset, out_size);
 
-			for (u32 i = 0; i < out_size; i++)
-			{
-				s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->Write8(i + ptr_read, buffer[i]);
-			}
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->WriteN(ptr_read, buffer, out_size);
 
 			resdata[0] = 0x00090081;
 			resdata[1] = 0;
 			resdata[2] = out_size;
 			resdata[3] = 0x4; //this is needed
 		}
+		delete[] buffer;
 		break;
 	}
 	case 0xA: //CalculateFileHashSHA256
@@ -195,29 +179,20 @@ void P9FS::Command(u32 data[], u32 numb)
 		u32 desc_hashtable = data[4];
 		u32 ptr_hashtable = data[5];
 #ifdef LOGFS
-		LOG("FS CalculateFileHashSHA256");
-		LOG("   file_handle=%" PRIx64, handle);
-		LOG("   size=%08X", size_hashtable);
-		LOG("   ptr=%08X", ptr_hashtable);
+		LOGDEBUG("FS CalculateFileHashSHA256");
+		LOGDEBUG("   file_handle=%" PRIx64, handle);
+		LOGDEBUG("   size=%08X", size_hashtable);
+		LOGDEBUG("   ptr=%08X", ptr_hashtable);
 #endif
-		auto a = m_fopen.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
 			resdata[0] = 0x000A0041;
 			resdata[1] = 0x0;
 			resdata[2] = 4;
-			u8* hash = a->data->Archobj->GetHashPtr();
+			u8* hash = file->GetHashPtr();
 
-			for (u32 i = 0; i < size_hashtable; i++)
-			{
-				s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(desc_hashtable >> 4) & 0xF]->Write8(i + ptr_hashtable, hash[i]);
-			}
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_hashtable >> 4) & 0xF]->WriteN(ptr_hashtable, hash, size_hashtable < 0x20 ? size_hashtable : 0x20);
 		}
 		break;
 	}
@@ -231,9 +206,9 @@ void P9FS::Command(u32 data[], u32 numb)
 		u32 ptr_write = data[8];
 
 #ifdef LOGFS
-		LOG("FS WriteFile %08x %08x %08x", size, desc_write, ptr_write);
-		LOG("   file_handle=%08X", handle);
-		LOG("   file_offset=%" PRIx64, file_offset);
+		LOGDEBUG("FS WriteFile %08x %08x %08x", size, desc_write, ptr_write);
+		LOGDEBUG("   file_handle=%08X", handle);
+		LOGDEBUG("   file_offset=%" PRIx64, file_offset);
 #endif
 		resdata[0] = 0x000B0182;
 		resdata[1] = 0xFFFFFFFF; //todo get the correct error
@@ -242,28 +217,20 @@ void P9FS::Command(u32 data[], u32 numb)
 		u8 *buffer = new u8[buffsize];
 		memset(buffer, 0, buffsize);
 
-		auto a = m_fopen.list;
-		while (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
-		{
-			for (u32 i = 0; i < size; i++)
-			{
-				s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Read8(i + ptr_write, buffer[i]);
-			}
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->ReadN(ptr_write, buffer, size);
 
 			u32 out_size = 0;
-			a->data->Archobj->write(buffer, size, file_offset, out_size);
+			file->write(buffer, size, file_offset, out_size);
 
 			resdata[0] = 0x000B0081;
 			resdata[1] = 0;
 			resdata[2] = out_size;
 			resdata[3] = 0x4; //this is needed
 		}
+		delete[] buffer;
 		break;
 	}
 	case 0xC: //CalcSavegameMAC
@@ -279,23 +246,17 @@ void P9FS::Command(u32 data[], u32 numb)
 		u32 out_desc = data[7];
 		u32 out_ptr = data[8];
 #ifdef LOGFS
-		LOG("FS CalcSavegameMAC");
-		LOG("   file_handle=%" PRIx64, handle);
-		LOG("   in  size=%08X, ptr=%08X", in_size, in_ptr);
-		LOG("   out size=%08X, ptr=%08X", out_size, out_ptr);
+		LOGDEBUG("FS CalcSavegameMAC");
+		LOGDEBUG("   file_handle=%" PRIx64, handle);
+		LOGDEBUG("   in  size=%08X, ptr=%08X", in_size, in_ptr);
+		LOGDEBUG("   out size=%08X, ptr=%08X", out_size, out_ptr);
 #endif
-		for (u32 i = 0; i < in_size; i++)
-		{
-			u8 data;
-			m_owner->m_kernel->m_IPCFIFOAdresses[(in_desc >> 4) & 0xF]->Read8(in_ptr + i, data);
-			printf("%02x ", data);
-		}
-		LOG("");
-		for (u32 i = 0; i < out_size; i++)
-		{
-			//s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(out_desc >> 4) & 0xF]->Write8(i + out_ptr, rand() % 255);
-			s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(out_desc >> 4) & 0xF]->Write8(i + out_ptr, 0x11);
-		}
+		u8* in_data = new u8[in_size];
+		memset(in_data, 0, in_size);
+		m_owner->m_kernel->m_IPCFIFOAdresses[(in_desc >> 4) & 0xF]->ReadN(in_ptr, in_data, in_size);
+		LOGHEX(in_data, in_size);
+		delete[] in_data;
+		m_owner->m_kernel->m_IPCFIFOAdresses[(out_desc >> 4) & 0xF]->Fill(out_ptr, 0x11, out_size);
 
 		resdata[0] = 0x000C0041;
 		resdata[1] = 0;
@@ -307,20 +268,14 @@ void P9FS::Command(u32 data[], u32 numb)
 		resdata[1] = 0xFFFFFFFF; //todo get the correct error
 		u64 handle = (data[1] >> 0) | ((u64)(data[2]) << 32);
 #ifdef LOGFS
-		LOG("FS GetFileSize=%" PRIx64, handle);
+		LOGDEBUG("FS GetFileSize=%" PRIx64, handle);
 #endif
-		auto a = m_fopen.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
 			resdata[0] = 0x000D00C0;
 			resdata[1] = 0x0;
-			u64 size = a->data->Archobj->getsize();
+			u64 size = file->getsize();
 			resdata[2] = (u32)size;
 			resdata[3] = size>>32;
 		}
@@ -333,21 +288,15 @@ void P9FS::Command(u32 data[], u32 numb)
 		u64 size = (data[1] >> 0) | ((u64)(data[2]) << 32);
 		u64 handle = (data[3] >> 0) | ((u64)(data[4]) << 32);
 #ifdef LOGFS
-		LOG("FS SetFileSize");
-		LOG("   file_handle=%" PRIx64, handle);
-		LOG("   size=%" PRIx64, size);
+		LOGDEBUG("FS SetFileSize");
+		LOGDEBUG("   file_handle=%" PRIx64, handle);
+		LOGDEBUG("   size=%" PRIx64, size);
 #endif
-		auto a = m_fopen.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
 			resdata[0] = 0x000E0040;
-			resdata[1] = a->data->Archobj->setsize(size);
+			resdata[1] = file->setsize(size);
 		}
 		break;
 	}
@@ -357,17 +306,11 @@ void P9FS::Command(u32 data[], u32 numb)
 		resdata[1] = 0xFFFFFFFF; //todo get the correct error
 		u64 handle = (data[1] >> 0) | ((u64)(data[2]) << 32);
 		LOG("CloseFile=%" PRIx64, handle);
-		auto a = m_fopen.list;
-		while (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
-		{
-			delete a->data->Archobj;
-			m_fopen.RemoveItem(a);
+			m_files.erase(handle);
+			delete file;
 			resdata[1] = 0;
 		}
 		break;
@@ -384,49 +327,43 @@ void P9FS::Command(u32 data[], u32 numb)
 
         //This is freed in the destructor of LowPath
         u8 *lowpath_data = new u8[file_lowpath_sz];
-        for(u32 i = 0; i < file_lowpath_sz; i++)
-        {
-            u8 sdata = 0;
-            s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(file_lowpath_desc >> 4) & 0xF]->Read8(i + file_lowpath_ptr, sdata);
-            lowpath_data[i] = sdata;
-        }
+        memset(lowpath_data, 0, file_lowpath_sz);
+        m_owner->m_kernel->m_IPCFIFOAdresses[(file_lowpath_desc >> 4) & 0xF]->ReadN(file_lowpath_ptr, lowpath_data, file_lowpath_sz);
 
         auto lowpath = new LowPath(file_lowpath_type, file_lowpath_sz, file_lowpath_desc, lowpath_data);
 
-        s_fsArchiveEntry *a = new s_fsArchiveEntry;
-        m_open.AddItem(a);
-        a->id = lastID++;
+        u64 archive_handle = lastID++;
+        Archive* archive = NULL;
 
 #ifdef LOGFS
-        LOG("FS OpenArchive stub %08x %08x %08x %08x", data[1], data[2], data[3], data[4]);
-        LOG("   archive_handle=%" PRIx64, a->id);
+        LOGDEBUG("FS OpenArchive stub %08x %08x %08x %08x", data[1], data[2], data[3], data[4]);
+        LOGDEBUG("   archive_handle=%" PRIx64, archive_handle);
 #endif
-		a->Archobj = NULL;
 		resdata[1] = 0;
 		try
 		{
 			switch (data[1])
 			{
 			case 0x1234567b: // ExtSaveData, and ExtSaveData for BOSS
-				a->Archobj = new Archive1234567b(this->m_owner, lowpath);
+				archive = new Archive1234567b(this->m_owner, lowpath);
 				break;
 			case 0x1234567c: // SystemSaveData
-				a->Archobj = new Archive1234567c(this->m_owner, lowpath);
+				archive = new Archive1234567c(this->m_owner, lowpath);
 				break;
 			case 0x1234567d: // NAND RW 
-				a->Archobj = new Archive1234567d(this->m_owner, lowpath);
+				archive = new Archive1234567d(this->m_owner, lowpath);
 				break;
 			case 0x1234567e: // NAND RO
-				a->Archobj = new Archive1234567e(this->m_owner, lowpath);
+				archive = new Archive1234567e(this->m_owner, lowpath);
 				break;
 			case 0x2345678a: //User/GameCard SaveData (for check), and other uses (FS can only mount the latter) (lo hi mediatype reserved) 
-				a->Archobj = new Archive2345678a(this->m_owner, lowpath);
+				archive = new Archive2345678a(this->m_owner, lowpath);
 				break;
 			case 0x2345678e: // SaveData, ExeFS, and RomFS (For fs:LDR, only ExeFS)
-				a->Archobj = new Archive2345678e(this->m_owner, lowpath);
+				archive = new Archive2345678e(this->m_owner, lowpath);
 				break;
 			case 0x567890B0: // NAND CTR FS
-				a->Archobj = new Archive567890b0(this->m_owner, lowpath);
+				archive = new Archive567890b0(this->m_owner, lowpath);
 				break;
 			default:
 				throw 0xc8804464;
@@ -437,9 +374,11 @@ void P9FS::Command(u32 data[], u32 numb)
 		{
 			resdata[1] = val;
 		}
+		if (archive)
+			m_archives[archive_handle] = archive;
 		resdata[0] = 0x001200c1;
-        resdata[2] = (u32)a->id;
-        resdata[3] = (u32)(a->id >> 32);
+        resdata[2] = (u32)archive_handle;
+        resdata[3] = (u32)(archive_handle >> 32);
         resdata[4] = 0x4; //this is needed
         delete lowpath;
         break;
@@ -450,12 +389,7 @@ void P9FS::Command(u32 data[], u32 numb)
 
 		char* str = new char[data[4] + 1];
 		memset(str, 0, data[4] + 1);
-		for (u32 i = 0; i < data[4]; i++) //Quota.dat
-		{
-			u8 sdata = 0;
-			m_owner->m_kernel->m_IPCFIFOAdresses[(data[5] >> 4) & 0xF]->Read8(i + data[6], sdata);
-			str[i] = sdata;
-		}
+		m_owner->m_kernel->m_IPCFIFOAdresses[(data[5] >> 4) & 0xF]->ReadN(data[6], (u8*)str, data[4]); //Quota.dat
 		LOG("%s",str);
 		resdata[0] = 0x00130040;
 		resdata[1] = 0x00000000;
@@ -471,24 +405,17 @@ void P9FS::Command(u32 data[], u32 numb)
 		u64 handle = (data[1] >> 0) | ((u64)(data[2]) << 32);
 
 #ifdef LOGFS
-		LOG("FS CloseArchive - stubbed");
-		LOG("   archive_handle=%" PRIx64, handle);
+		LOGDEBUG("FS CloseArchive - stubbed");
+		LOGDEBUG("   archive_handle=%" PRIx64, handle);
 #endif
 
-		auto a = m_open.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
+		Archive* archive = FindArchive(handle);
 
-		if (a)
+		if (archive)
 		{
 			//TODO: Should we really delete this or just ignore this call as kernel calls ReopenArchive with same handleid soon after closing it
-			m_open.RemoveItem(a);
-			delete a->data->Archobj;
-			delete a->data;
+			m_archives.erase(handle);
+			delete archive;
 		}
 
 		resdata[0] = 0x00160040;
@@ -499,8 +426,8 @@ void P9FS::Command(u32 data[], u32 numb)
 	{
 		u64 handle = (data[1] >> 0) | ((u64)(data[2]) << 32);
 #ifdef LOGFS
-		LOG("FS Unk17 - stubbed");
-		LOG("   archive_handle=%" PRIx64, handle);
+		LOGDEBUG("FS Unk17 - stubbed");
+		LOGDEBUG("   archive_handle=%" PRIx64, handle);
 #endif
 		resdata[0] = 0x00170080;
 		resdata[1] = 0;
@@ -510,7 +437,7 @@ void P9FS::Command(u32 data[], u32 numb)
 	case 0x18: //GetCardType
 	{
 #ifdef LOGFS
-		LOG("GetCardType - stubbed");
+		LOGDEBUG("GetCardType - stubbed");
 #endif
 		resdata[0] = 0x00180080;
 		resdata[1] = 0;
@@ -520,7 +447,7 @@ void P9FS::Command(u32 data[], u32 numb)
 	case 0x1C: //GetSdmcDetected
 	{
 #ifdef LOGFS
-		LOG("GetSdmcDetected - stubbed");
+		LOGDEBUG("GetSdmcDetected - stubbed");
 #endif
 		resdata[0] = 0x001C0080;
 		resdata[1] = 0;
@@ -530,7 +457,7 @@ void P9FS::Command(u32 data[], u32 numb)
 	case 0x1D: //GetSdmcWritable
 	{
 #ifdef LOGFS
-		LOG("GetSdmcWritable - stubbed");
+		LOGDEBUG("GetSdmcWritable - stubbed");
 #endif
 		resdata[0] = 0x001D0080;
 		resdata[1] = 0;
@@ -540,7 +467,7 @@ void P9FS::Command(u32 data[], u32 numb)
 	case 0x26: //GetCardSlotInserted
 	{
 #ifdef LOGFS
-		LOG("GetCardSlotInserted - stubbed");
+		LOGDEBUG("GetCardSlotInserted - stubbed");
 #endif
 		resdata[0] = 0x00260080;
 		resdata[1] = 0;
@@ -561,11 +488,11 @@ void P9FS::Command(u32 data[], u32 numb)
 		u32 ptr_read = data[11];
 
 #ifdef LOGFS
-		LOG("FS ReadFileWrapper (SHA-256 not implemented) %08x %08x %08x", size, alinement, size_hashtable);
-		LOG("   file_handle=%" PRIx64, handle);
-		LOG("   file_offset=%" PRIx64, file_offset);
-		LOG("   pointer=%08x", ptr_read);
-		LOG("   modulename=%s", m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->m_process->GetName());
+		LOGDEBUG("FS ReadFileWrapper (SHA-256 not implemented) %08x %08x %08x", size, alinement, size_hashtable);
+		LOGDEBUG("   file_handle=%" PRIx64, handle);
+		LOGDEBUG("   file_offset=%" PRIx64, file_offset);
+		LOGDEBUG("   pointer=%08x", ptr_read);
+		LOGDEBUG("   modulename=%s", m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->m_process->GetName());
 #endif
 		resdata[0] = 0x004D0040;
 		resdata[1] = 0xFFFFFFFF; //todo get the correct error
@@ -576,28 +503,20 @@ void P9FS::Command(u32 data[], u32 numb)
 		u8 *buffer = new u8[buffsize];
 		memset(buffer, 0, buffsize);
 
-		auto a = m_fopen.list;
-		while (a)
-		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
 			u32 out_size = 0;
-			a->data->Archobj->read(buffer, size, file_offset, out_size);
+			file->read(buffer, size, file_offset, out_size);
 			
-			for (u32 i = 0; i < out_size; i++)
-			{
-				s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->Write8(i + ptr_read, buffer[i]);
-			}
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_read >> 4) & 0xF]->WriteN(ptr_read, buffer, out_size);
 
 			resdata[0] = 0x004D0081;
 			resdata[1] = 0;
 			resdata[2] = out_size;
 			resdata[3] = 0x4; //this is needed
 		}
+		delete[] buffer;
 		break;
 	}
 	case 0x4E: //WriteFileWrapper
@@ -614,9 +533,9 @@ void P9FS::Command(u32 data[], u32 numb)
 		u32 ptr_hash = data[12];
 
 #ifdef LOGFS
-		LOG("FS WriteFileWrapper %08x %08x %08x %08x %08x", size, desc_write, ptr_write, unk, size_hashtable);
-		LOG("   file_handle=%08X", handle);
-		LOG("   file_offset=%" PRIx64, file_offset);
+		LOGDEBUG("FS WriteFileWrapper %08x %08x %08x %08x %08x", size, desc_write, ptr_write, unk, size_hashtable);
+		LOGDEBUG("   file_handle=%08X", handle);
+		LOGDEBUG("   file_offset=%" PRIx64, file_offset);
 #endif
 		resdata[0] = 0x000B0182;
 		resdata[1] = 0xFFFFFFFF; //todo get the correct error
@@ -625,40 +544,32 @@ void P9FS::Command(u32 data[], u32 numb)
 		u8 *buffer = new u8[buffsize];
 		memset(buffer, 0, buffsize);
 
-		auto a = m_fopen.list;
-		while (a)
+		P9File* file = FindFile(handle);
+		if (file)
 		{
-			if (a->data->id == handle)
-				break;
-			a = a->next;
-		}
-		if (a)
-		{
-			for (u32 i = 0; i < size; i++)
-			{
-				s32 ret = m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->Read8(i + ptr_write, buffer[i]);
-			}
+			m_owner->m_kernel->m_IPCFIFOAdresses[(desc_write >> 4) & 0xF]->ReadN(ptr_write, buffer, size);
 
 			u32 out_size = 0;
-			a->data->Archobj->write(buffer, size, file_offset, out_size);
+			file->write(buffer, size, file_offset, out_size);
 
 			resdata[0] = 0x000B0081;
 			resdata[1] = 0;
 			resdata[2] = out_size;
 			resdata[3] = 0x4; //this is needed
 		}
+		delete[] buffer;
 		break;
 	}
     case 0x4F: //0x004F0080 only data[1] used stored in seperate container (Bit(0 - 12) at 080949f0 + 0xC, Bit(12-24) 080949f0 + 0xE) nothing else done here
 #ifdef LOGFS
-        LOG("FS unk 0x4F stub (uppern 8 Bit unused)%08x (unused) %08x", data[1], data[2]);
+        LOGDEBUG("FS unk 0x4F stub (uppern 8 Bit unused)%08x (unused) %08x", data[1], data[2]);
 #endif
         resdata[0] = 0x004F0040;
         resdata[1] = 0x00000000;
         break;
     case 0x50: //dose nothing
 #ifdef LOGFS
-        LOG("FS init stub %u", data[1]);
+        LOGDEBUG("FS init stub %u", data[1]);
 #endif
         resdata[0] = 0x00500040;
         resdata[1] = 0x00000000;
@@ -0,0 +1,322 @@
+#define LOG_CLASS LOGCLASS_FS
+
+#include "Kernel.h"
+#include "Hardware.h"
+#include "Process9.h"
+
+#include <sys/stat.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#define HASH_CACHE_PATH "./NAND/sha256.cache"
+#define HASH_CHUNK 0x100000 // read at once, the file is never in memory as a whole
+
+struct HashEntry {
+    std::string path;
+    u64 offset;
+    u64 size;
+    u64 file_size;
+    u64 mtime;
+    u8 hash[0x20];
+    bool done; // false while the worker has it
+};
+
+struct HashJob {
+    std::string key;
+    std::string path;
+    u64 offset;
+    u64 size;
+    u64 file_size;
+    u64 mtime;
+};
+
+struct HashCacheState {
+    HashCacheState() : loaded(false), working(false) {}
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::unordered_map<std::string, HashEntry> entries;
+    std::deque<HashJob> jobs;
+    bool loaded;
+    bool working;
+};
+
+// never freed, the worker may still be hashing while the emulator exits
+static HashCacheState* s_cache = new HashCacheState();
+
+static std::string MakeKey(const std::string& path, u64 offset, u64 size)
+{
+    char range[0x30];
+    snprintf(range, sizeof(range), "@%" PRIx64 "+%" PRIx64, offset, size);
+    return path + range;
+}
+
+static bool StatFile(const char* path, u64& size_out, u64& mtime_out)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return false;
+    size_out = st.st_size;
+    mtime_out = (u64)st.st_mtime;
+    return true;
+}
+
+static bool ParseHash(const char* hex, u8* hash_out)
+{
+    for (int i = 0; i < 0x40; i++)
+    {
+        char c = hex[i];
+        u8 v;
+        if (c >= '0' && c <= '9')
+            v = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            v = c - 'a' + 10;
+        else
+            return false;
+        if (i & 1)
+            hash_out[i / 2] |= v;
+        else
+            hash_out[i / 2] = v << 4;
+    }
+    return true;
+}
+
+static void Write(FILE* fd, const HashEntry& entry)
+{
+    char hex[0x41];
+    for (int i = 0; i < 0x20; i++)
+        snprintf(hex + i * 2, 3, "%02x", entry.hash[i]);
+    fprintf(fd, "%s %" PRIx64 " %" PRIx64 " %" PRIx64 " %" PRIx64 " %s\n", hex, entry.file_size, entry.mtime, entry.offset, entry.size, entry.path.c_str());
+}
+
+static void Append(const HashEntry& entry)
+{
+    FILE* fd = Common::fopen_mkdir(HASH_CACHE_PATH, "a");
+    if (fd == NULL)
+    {
+        XDSERROR("opening %s", HASH_CACHE_PATH);
+        return;
+    }
+    Write(fd, entry);
+    fclose(fd);
+}
+
+static void Save()
+{
+    FILE* fd = Common::fopen_mkdir(HASH_CACHE_PATH, "w");
+    if (fd == NULL)
+    {
+        XDSERROR("opening %s", HASH_CACHE_PATH);
+        return;
+    }
+    for (auto it = s_cache->entries.begin(); it != s_cache->entries.end(); ++it)
+    {
+        if (it->second.done)
+            Write(fd, it->second);
+    }
+    fclose(fd);
+}
+
+// one line per hash: hash file_size mtime offset size path, later lines win
+static void Load()
+{
+    if (s_cache->loaded)
+        return;
+    s_cache->loaded = true;
+    FILE* fd = fopen(HASH_CACHE_PATH, "r");
+    if (fd == NULL)
+        return;
+
+    char line[0x500];
+    u32 lines = 0;
+    while (fgets(line, sizeof(line), fd))
+    {
+        HashEntry entry;
+        u64 values[4];
+        char* p = line + 0x40;
+        if (strlen(line) < 0x41 || !ParseHash(line, entry.hash))
+            continue;
+        for (int i = 0; i < 4; i++)
+            values[i] = strtoull(p, &p, 16);
+        if (*p++ != ' ')
+            continue;
+        entry.path = p;
+        while (!entry.path.empty() && (entry.path.back() == '\n' || entry.path.back() == '\r'))
+            entry.path.pop_back();
+        entry.file_size = values[0];
+        entry.mtime = values[1];
+        entry.offset = values[2];
+        entry.size = values[3];
+        entry.done = true;
+        s_cache->entries[MakeKey(entry.path, entry.offset, entry.size)] = entry;
+        lines++;
+    }
+    fclose(fd);
+    LOG("%u hashes in %s", (u32)s_cache->entries.size(), HASH_CACHE_PATH);
+
+    // contents that were hashed again left their old line behind
+    if (lines > s_cache->entries.size())
+        Save();
+}
+
+static bool HashRange(const char* path, u64 offset, u64 size, u8* hash_out)
+{
+    FILE* fd = fopen(path, "rb");
+    if (fd == NULL)
+        return false;
+    u8* buffer = new u8[HASH_CHUNK];
+    Common::Sha256 sha;
+    bool ok = true;
+    for (u64 done = 0; done < size;)
+    {
+        u32 part = size - done < HASH_CHUNK ? (u32)(size - done) : HASH_CHUNK;
+        if (Common::ReadFileAt(fd, buffer, part, offset + done) != part)
+        {
+            XDSERROR("reading %s for hashing", path);
+            ok = false;
+            break;
+        }
+        sha.Update(buffer, part);
+        done += part;
+    }
+    delete[] buffer;
+    fclose(fd);
+    if (ok)
+        sha.Final(hash_out);
+    return ok;
+}
+
+// called with the lock held, the entry is dropped if the file changed while it was hashed
+static void Finish(const HashJob& job, bool ok, const u8* hash)
+{
+    auto it = s_cache->entries.find(job.key);
+    if (it == s_cache->entries.end() || it->second.done || it->second.file_size != job.file_size || it->second.mtime != job.mtime)
+        return;
+    if (ok)
+    {
+        memcpy(it->second.hash, hash, 0x20);
+        it->second.done = true;
+        Append(it->second);
+    }
+    else
+    {
+        s_cache->entries.erase(it);
+    }
+    s_cache->finished.notify_all();
+}
+
+static void Worker()
+{
+    std::unique_lock<std::mutex> lock(s_cache->mutex);
+    while (!s_cache->jobs.empty())
+    {
+        HashJob job = s_cache->jobs.front();
+        s_cache->jobs.pop_front();
+        lock.unlock();
+        u8 hash[0x20];
+        bool ok = HashRange(job.path.c_str(), job.offset, job.size, hash);
+        lock.lock();
+        Finish(job, ok, hash);
+    }
+    s_cache->working = false;
+    lock.unlock();
+    LogReleaseThread();
+}
+
+static bool MakeJob(const char* path, u64 offset, u64 size, HashJob& job_out)
+{
+    if (!StatFile(path, job_out.file_size, job_out.mtime))
+        return false;
+    job_out.path = path;
+    job_out.offset = offset;
+    job_out.size = size;
+    job_out.key = MakeKey(job_out.path, offset, size);
+    return true;
+}
+
+static bool Matches(const HashEntry& entry, const HashJob& job)
+{
+    return entry.file_size == job.file_size && entry.mtime == job.mtime;
+}
+
+void P9HashCache::Prefetch(const char* path, u64 offset, u64 size)
+{
+    std::lock_guard<std::mutex> lock(s_cache->mutex);
+    Load();
+    HashJob job;
+    if (!MakeJob(path, offset, size, job))
+        return;
+    auto it = s_cache->entries.find(job.key);
+    if (it != s_cache->entries.end() && Matches(it->second, job))
+        return; // known or on its way
+
+    HashEntry& entry = s_cache->entries[job.key];
+    entry.path = job.path;
+    entry.offset = offset;
+    entry.size = size;
+    entry.file_size = job.file_size;
+    entry.mtime = job.mtime;
+    entry.done = false;
+    s_cache->jobs.push_back(job);
+    if (!s_cache->working)
+    {
+        s_cache->working = true;
+        std::thread(Worker).detach();
+    }
+}
+
+bool P9HashCache::Get(const char* path, u64 offset, u64 size, u8* hash_out)
+{
+    std::unique_lock<std::mutex> lock(s_cache->mutex);
+    Load();
+    HashJob job;
+    if (!MakeJob(path, offset, size, job))
+        return false;
+
+    for (;;)
+    {
+        auto it = s_cache->entries.find(job.key);
+        if (it == s_cache->entries.end() || !Matches(it->second, job))
+        {
+            HashEntry& entry = s_cache->entries[job.key];
+            entry.path = job.path;
+            entry.offset = offset;
+            entry.size = size;
+            entry.file_size = job.file_size;
+            entry.mtime = job.mtime;
+            entry.done = false;
+            break;
+        }
+        if (it->second.done)
+        {
+            memcpy(hash_out, it->second.hash, 0x20);
+            return true;
+        }
+
+        // a job the worker has not started is done right here, else it is waited for
+        bool queued = false;
+        for (auto j = s_cache->jobs.begin(); j != s_cache->jobs.end(); ++j)
+        {
+            if (j->key == job.key)
+            {
+                s_cache->jobs.erase(j);
+                queued = true;
+                break;
+            }
+        }
+        if (queued)
+            break;
+        s_cache->finished.wait(lock);
+    }
+
+    lock.unlock();
+    u8 hash[0x20];
+    bool ok = HashRange(path, offset, size, hash);
+    lock.lock();
+    Finish(job, ok, hash);
+    if (ok)
+        memcpy(hash_out, hash, 0x20);
+    return ok;
+}
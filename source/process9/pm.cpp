@@ -1,9 +1,14 @@
+#define LOG_CLASS LOGCLASS_P9
+
 #include "Kernel.h"
 #include "Hardware.h"
 #include "Process9.h"
 #include "Bootloader.h"
 
+// PM requests at debug level
+#if LOG_MIN_LEVEL <= LOGLEVEL_DEBUG
 #define LOGPM
+#endif
 
 P9PM::P9PM(Process9* owner) :m_open(), m_owner(owner), handlecount(0x100000001)
 {
@@ -14,8 +19,6 @@ P9PM::~P9PM()
 
 }
 
-extern FILE* openapp(u32 titlehigh, u32 titlelow); //this is from Bootloader.cpp
-
 void P9PM::Command(u32 data[],u32 numb)
 {
     u32 resdata[0x200];
@@ -40,45 +43,22 @@ void P9PM::Command(u32 data[],u32 numb)
             LOG("pm getexheader handle=%" PRIx64 ", titleid=%" PRIx64, handle, a->data->title);
             KMemoryMap* map = m_owner->m_kernel->m_IPCFIFOAdresses[(data[3] >> 4) &0xF];
             resdata[1] = 0xE0000000;
-            FILE * fd = openapp(a->data->title >> 32, (u32)a->data->title);
+            const NcchContainer* container;
+            FILE * fd = openapp(a->data->title >> 32, (u32)a->data->title, container);
             if (fd)
             {
-                //open the container
-                char ex[0x400];
-                ctr_ncchheader loader_h;
-                u32 ncch_off = 0;
-
-                // Read header.
-                if (fread(&loader_h, sizeof(loader_h), 1, fd) != 1) {
-                    XDSERROR("failed to read header.");
-                    break;
-                }
-                // Load NCCH
-                if (memcmp(&loader_h.magic, "NCCH", 4) != 0) {
-                    XDSERROR("invalid magic.. wrong file?");
-                    break;
-                }
-
-                // Read Exheader.
-                if (fread(&ex, 0x400, 1, fd) != 1) { //this is fixed 
-                    XDSERROR("failed to read exheader.");
-                    break;
-                }
-                for (int i = 0; i < sizeof(ex); i++)
+                fclose(fd);
+                if (container)
                 {
-                    if (map->Write8(data[4] + i, ex[i]) != Success)
-                    {
-                        break;
-                    }
+                    map->WriteN(data[4], (u8*)&container->exheader, 0x400); //this is fixed
+                    resdata[1] = 0;
                 }
-                resdata[1] = 0;
-
             }
         }
         else
         {
 #ifdef LOGPM
-            LOG("pm getexheader handle=%" PRIx64, handle);
+            LOGDEBUG("pm getexheader handle=%" PRIx64, handle);
 #endif
             resdata[1] = 0xE0000000; //todo correct error
         }
@@ -88,7 +68,7 @@ void P9PM::Command(u32 data[],u32 numb)
     {
         u64 title = (data[1] >> 0) | ((u64)(data[2]) << 32);
 #ifdef LOGPM
-        LOG("pm register %08x %08x", data[1], data[2]);
+        LOGDEBUG("pm register %08x %08x", data[1], data[2]);
 #endif
         if ((data[3] >> 24) != 0)
             LOG("register flags %02x %02x", (data[3] >> 24), (data[3 + 4] >> 24));
@@ -1,9 +1,14 @@
+#define LOG_CLASS LOGCLASS_P9
+
 #include "Kernel.h"
 #include "Hardware.h"
 #include "Process9.h"
 #include "Bootloader.h"
 
+// PS requests at debug level
+#if LOG_MIN_LEVEL <= LOGLEVEL_DEBUG
 #define LOGPM
+#endif
 
 P9PS::P9PS(Process9* owner) : m_owner(owner)
 {
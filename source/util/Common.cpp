@@ -8,6 +8,8 @@
 #include <codecvt>
 #else
 #include <iconv.h>
+#include <sys/mman.h>
+#include <dirent.h>
 #endif
 
 #include <sys/stat.h>
@@ -105,21 +107,15 @@ namespace Common {
 
     unsigned int CountLeadingZeros(unsigned int num)
     {
-        unsigned int x = 0x80000000;
-        unsigned int zero_count = 0;
-
-        for (int i = 0; i < 32; i++)
-        { 
-            if ((x & num) == 0)
-            {
-                zero_count++;
-                x >>= 1;
-                continue;
-            }
-            break;
-        }
-
-        return zero_count;
+        if (num == 0)
+            return 32;
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse(&index, num);
+        return 31 - index;
+#else
+        return __builtin_clz(num);
+#endif
     }
 
 	/* Opens the file, creating directories in its pathspec if necessary */
@@ -153,4 +149,126 @@ namespace Common {
 
 		return temp;
 	}
+
+#ifdef _WIN32
+	bool ListDirectory(const char* path, std::vector<std::string>& names_out)
+	{
+		WIN32_FIND_DATAA entry;
+		HANDLE find = FindFirstFileA((std::string(path) + "\\*").c_str(), &entry);
+		if (find == INVALID_HANDLE_VALUE)
+			return false;
+		do {
+			if (strcmp(entry.cFileName, ".") != 0 && strcmp(entry.cFileName, "..") != 0)
+				names_out.push_back(entry.cFileName);
+		} while (FindNextFileA(find, &entry));
+		FindClose(find);
+		return true;
+	}
+	bool MapFileView(FILE* fd, u64 offset, u64 size, FileView* view_out)
+	{
+		HANDLE file = (HANDLE)_get_osfhandle(_fileno(fd));
+		LARGE_INTEGER file_size;
+		if (size == 0 || !GetFileSizeEx(file, &file_size) || (u64)file_size.QuadPart < offset + size)
+			return false;
+
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		u64 start = offset - offset % info.dwAllocationGranularity;
+		HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL)
+			return false;
+		void* base = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, (SIZE_T)(offset + size - start));
+		if (base == NULL) {
+			CloseHandle(mapping);
+			return false;
+		}
+		view_out->data = (const u8*)base + (offset - start);
+		view_out->base = base;
+		view_out->length = offset + size - start;
+		view_out->handle = mapping;
+		return true;
+	}
+	void UnmapFileView(FileView* view)
+	{
+		UnmapViewOfFile(view->base);
+		CloseHandle((HANDLE)view->handle);
+	}
+	s64 ReadFileAt(FILE* fd, void* buffer, u32 size, u64 offset)
+	{
+		OVERLAPPED at = {};
+		at.Offset = (DWORD)offset;
+		at.OffsetHigh = (DWORD)(offset >> 32);
+		DWORD done;
+		if (!ReadFile((HANDLE)_get_osfhandle(_fileno(fd)), buffer, size, &done, &at))
+			return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+		return done;
+	}
+	s64 WriteFileAt(FILE* fd, const void* buffer, u32 size, u64 offset)
+	{
+		OVERLAPPED at = {};
+		at.Offset = (DWORD)offset;
+		at.OffsetHigh = (DWORD)(offset >> 32);
+		DWORD done;
+		if (!WriteFile((HANDLE)_get_osfhandle(_fileno(fd)), buffer, size, &done, &at))
+			return -1;
+		return done;
+	}
+#else
+	bool ListDirectory(const char* path, std::vector<std::string>& names_out)
+	{
+		DIR* dir = opendir(path);
+		if (dir == NULL)
+			return false;
+		while (struct dirent* entry = readdir(dir)) {
+			if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+				names_out.push_back(entry->d_name);
+		}
+		closedir(dir);
+		return true;
+	}
+	bool MapFileView(FILE* fd, u64 offset, u64 size, FileView* view_out)
+	{
+		struct stat st;
+		if (size == 0 || fstat(fileno(fd), &st) != 0 || (u64)st.st_size < offset + size)
+			return false;
+
+		u64 start = offset - offset % sysconf(_SC_PAGESIZE);
+		void* base = mmap(NULL, offset + size - start, PROT_READ, MAP_SHARED, fileno(fd), start);
+		if (base == MAP_FAILED)
+			return false;
+		view_out->data = (const u8*)base + (offset - start);
+		view_out->base = base;
+		view_out->length = offset + size - start;
+		view_out->handle = NULL;
+		return true;
+	}
+	void UnmapFileView(FileView* view)
+	{
+		munmap(view->base, view->length);
+	}
+	s64 ReadFileAt(FILE* fd, void* buffer, u32 size, u64 offset)
+	{
+		u32 done = 0;
+		while (done < size) {
+			ssize_t ret = pread(fileno(fd), (u8*)buffer + done, size - done, offset + done);
+			if (ret < 0)
+				return -1;
+			if (ret == 0)
+				break;
+			done += ret;
+		}
+		return done;
+	}
+	s64 WriteFileAt(FILE* fd, const void* buffer, u32 size, u64 offset)
+	{
+		u32 done = 0;
+		while (done < size) {
+			ssize_t ret = pwrite(fileno(fd), (const u8*)buffer + done, size - done, offset + done);
+			if (ret < 0)
+				return -1;
+			done += ret;
+		}
+		return done;
+	}
+#endif
 }
@@ -0,0 +1,281 @@
+#include "Common.h"
+#include "Util.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+#define LOG_SLOT_SIZE  256
+#define LOG_RING_SLOTS 1024
+
+#define LOGSLOT_MORE 1 // the message goes on in the next slot
+
+struct LogSlot {
+    u16 len;
+    u8 flags;
+    u8 level;
+    char text[LOG_SLOT_SIZE - 4];
+};
+
+// written by one thread and read by the writer, head and tail only ever grow
+struct LogRing {
+    LogSlot slots[LOG_RING_SLOTS];
+    std::atomic<u32> head;
+    std::atomic<u32> tail;
+    LogRing* next;
+    bool owned; // cleared by LogReleaseThread, the next thread that logs takes the ring over
+};
+
+// kernel (the svcs), ipc, fs and p9 log every request, they only show problems unless -log asks for more
+u8 log_levels[LOGCLASS_COUNT] = {
+    LOGLEVEL_INFO, LOGLEVEL_WARNING, LOGLEVEL_WARNING, LOGLEVEL_WARNING, LOGLEVEL_WARNING,
+    LOGLEVEL_INFO, LOGLEVEL_INFO, LOGLEVEL_INFO, LOGLEVEL_INFO,
+};
+
+static const char* const s_class_names[LOGCLASS_COUNT] = {
+    "general", "kernel", "ipc", "fs", "p9", "gpu", "dsp", "hw", "citra",
+};
+static const char* const s_level_names[LOGLEVEL_NONE + 1] = {
+    "trace", "debug", "info", "warning", "error", "none",
+};
+
+static THREAD_LOCAL LogRing* t_ring = NULL;
+// the writer walks the rings without a lock, so they are never freed, threads that end hand theirs back
+static std::atomic<LogRing*> s_rings(NULL);
+static std::mutex s_rings_mutex;
+static std::atomic<bool> s_running(false);
+static bool s_stopped = false;
+static std::thread s_writer;
+
+static bool Drain(LogRing* ring, char* buf, u32 size)
+{
+    u32 tail = ring->tail.load(std::memory_order_relaxed);
+    u32 head = ring->head.load(std::memory_order_acquire);
+    if (tail == head)
+        return false;
+
+    u32 used = 0;
+    for (; tail != head; tail++) {
+        const LogSlot& slot = ring->slots[tail % LOG_RING_SLOTS];
+        if (used + slot.len + 1 > size) {
+            fwrite(buf, 1, used, stdout);
+            used = 0;
+        }
+        memcpy(buf + used, slot.text, slot.len);
+        used += slot.len;
+        if (!(slot.flags & LOGSLOT_MORE))
+            buf[used++] = '\n';
+    }
+    fwrite(buf, 1, used, stdout);
+    ring->tail.store(tail, std::memory_order_release);
+    return true;
+}
+
+static bool DrainAll()
+{
+    static char buf[0x10000];
+    bool any = false;
+    for (LogRing* ring = s_rings.load(std::memory_order_acquire); ring; ring = ring->next)
+        any |= Drain(ring, buf, sizeof(buf));
+    if (any)
+        fflush(stdout);
+    return any;
+}
+
+static void WriterMain()
+{
+    while (s_running.load(std::memory_order_relaxed)) {
+        if (!DrainAll())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static void LogShutdown()
+{
+    std::lock_guard<std::mutex> lock(s_rings_mutex);
+    if (!s_running)
+        return;
+    s_running = false;
+    s_writer.join();
+    DrainAll();
+    s_stopped = true;
+}
+
+static LogRing* GetRing()
+{
+    if (likely(t_ring != NULL))
+        return t_ring;
+
+    std::lock_guard<std::mutex> lock(s_rings_mutex);
+    if (s_stopped)
+        return NULL;
+    // the messages the last owner left are still written before the new ones
+    LogRing* ring = s_rings.load(std::memory_order_relaxed);
+    while (ring && ring->owned)
+        ring = ring->next;
+    if (ring == NULL) {
+        ring = new LogRing;
+        ring->head = 0;
+        ring->tail = 0;
+        ring->next = s_rings.load(std::memory_order_relaxed);
+        s_rings.store(ring, std::memory_order_release);
+    }
+    ring->owned = true;
+    t_ring = ring;
+
+    if (!s_running) {
+        s_running = true;
+        s_writer = std::thread(WriterMain);
+        atexit(LogShutdown);
+    }
+    return ring;
+}
+
+// waits for a free slot, the writer can only be behind by a full ring
+static LogSlot& NextSlot(LogRing* ring)
+{
+    u32 head = ring->head.load(std::memory_order_relaxed);
+    while (head - ring->tail.load(std::memory_order_acquire) >= LOG_RING_SLOTS)
+        std::this_thread::yield();
+    return ring->slots[head % LOG_RING_SLOTS];
+}
+
+static void Commit(LogRing* ring)
+{
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+static void Push(LogRing* ring, int level, const char* text, u32 len)
+{
+    do {
+        LogSlot& slot = NextSlot(ring);
+        u32 part = len < sizeof(slot.text) ? len : sizeof(slot.text);
+        memcpy(slot.text, text, part);
+        slot.len = part;
+        slot.level = level;
+        slot.flags = part < len ? LOGSLOT_MORE : 0;
+        Commit(ring);
+        text += part;
+        len -= part;
+    } while (len);
+}
+
+void LogWrite(int log_class, int level, const char* format, ...)
+{
+    LogRing* ring = GetRing();
+    va_list args;
+
+    if (unlikely(ring == NULL)) {
+        // the writer is gone, this only happens while exiting
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+        printf("\n");
+        return;
+    }
+
+    // most messages are formatted right into their slot
+    LogSlot& slot = NextSlot(ring);
+    va_start(args, format);
+    int len = vsnprintf(slot.text, sizeof(slot.text), format, args);
+    va_end(args);
+
+    if (len < 0) {
+        len = 0;
+    } else if ((u32)len >= sizeof(slot.text)) {
+        char* text = new char[len + 1];
+        va_start(args, format);
+        vsnprintf(text, len + 1, format, args);
+        va_end(args);
+        Push(ring, level, text, len);
+        delete[] text;
+        len = -1;
+    }
+    if (len >= 0) {
+        slot.len = len;
+        slot.level = level;
+        slot.flags = 0;
+        Commit(ring);
+    }
+
+    if (level >= LOGLEVEL_ERROR)
+        LogFlush();
+}
+
+void LogHex(int log_class, int level, const u8* data, u32 size)
+{
+    static const char digits[] = "0123456789abcdef";
+    char* text = new char[size * 3 + 1];
+    for (u32 i = 0; i < size; i++) {
+        text[i * 3] = digits[data[i] >> 4];
+        text[i * 3 + 1] = digits[data[i] & 0xF];
+        text[i * 3 + 2] = ' ';
+    }
+    text[size ? size * 3 - 1 : 0] = '\0';
+    LogWrite(log_class, level, "%s", text);
+    delete[] text;
+}
+
+void LogReleaseThread()
+{
+    if (t_ring == NULL)
+        return;
+    std::lock_guard<std::mutex> lock(s_rings_mutex);
+    t_ring->owned = false;
+    t_ring = NULL;
+}
+
+void LogFlush()
+{
+    if (!s_running)
+        return;
+    for (LogRing* ring = s_rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        u32 head = ring->head.load(std::memory_order_acquire);
+        while ((s32)(head - ring->tail.load(std::memory_order_acquire)) > 0 && s_running)
+            std::this_thread::yield();
+    }
+}
+
+static int FindName(const char* const* names, int count, const char* name, size_t len)
+{
+    for (int i = 0; i < count; i++) {
+        if (strlen(names[i]) == len && strncmp(names[i], name, len) == 0)
+            return i;
+    }
+    return -1;
+}
+
+bool LogParseLevels(const char* rules)
+{
+    const char* p = rules;
+    while (*p) {
+        while (*p == ' ')
+            p++;
+        if (*p == '\0')
+            break;
+        const char* colon = strchr(p, ':');
+        if (colon == NULL)
+            return false;
+        const char* end = colon + 1;
+        while (*end && *end != ' ')
+            end++;
+
+        int level = FindName(s_level_names, LOGLEVEL_NONE + 1, colon + 1, end - colon - 1);
+        if (level < 0)
+            return false;
+        if (colon - p == 1 && *p == '*') {
+            for (int i = 0; i < LOGCLASS_COUNT; i++)
+                log_levels[i] = level;
+        } else {
+            int log_class = FindName(s_class_names, LOGCLASS_COUNT, p, colon - p);
+            if (log_class < 0)
+                return false;
+            log_levels[log_class] = level;
+        }
+        p = end;
+    }
+    return true;
+}
@@ -0,0 +1,223 @@
+#include "Common.h"
+#include "Util.h"
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && (defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#define SHA256_SHANI
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+static const u32 sha256_k[64] =
+{ 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2 };
+
+#define SHA2_SHFR(x, n)    (x >> n)
+#define SHA2_ROTR(x, n)   ((x >> n) | (x << ((sizeof(x) << 3) - n)))
+#define SHA2_CH(x, y, z)  ((x & y) ^ (~x & z))
+#define SHA2_MAJ(x, y, z) ((x & y) ^ (x & z) ^ (y & z))
+#define SHA256_F1(x) (SHA2_ROTR(x,  2) ^ SHA2_ROTR(x, 13) ^ SHA2_ROTR(x, 22))
+#define SHA256_F2(x) (SHA2_ROTR(x,  6) ^ SHA2_ROTR(x, 11) ^ SHA2_ROTR(x, 25))
+#define SHA256_F3(x) (SHA2_ROTR(x,  7) ^ SHA2_ROTR(x, 18) ^ SHA2_SHFR(x,  3))
+#define SHA256_F4(x) (SHA2_ROTR(x, 17) ^ SHA2_ROTR(x, 19) ^ SHA2_SHFR(x, 10))
+
+static void TransformGeneric(u32 state[8], const u8* message, size_t block_nb)
+{
+	u32 w[64];
+	u32 wv[8];
+	u32 t1, t2;
+	for (size_t i = 0; i < block_nb; i++) {
+		const u8* sub_block = message + (i << 6);
+		for (int j = 0; j < 16; j++) {
+			const u8* p = &sub_block[j << 2];
+			w[j] = (u32)p[0] << 24 | (u32)p[1] << 16 | (u32)p[2] << 8 | p[3];
+		}
+		for (int j = 16; j < 64; j++) {
+			w[j] = SHA256_F4(w[j - 2]) + w[j - 7] + SHA256_F3(w[j - 15]) + w[j - 16];
+		}
+		for (int j = 0; j < 8; j++) {
+			wv[j] = state[j];
+		}
+		for (int j = 0; j < 64; j++) {
+			t1 = wv[7] + SHA256_F2(wv[4]) + SHA2_CH(wv[4], wv[5], wv[6])
+				+ sha256_k[j] + w[j];
+			t2 = SHA256_F1(wv[0]) + SHA2_MAJ(wv[0], wv[1], wv[2]);
+			wv[7] = wv[6];
+			wv[6] = wv[5];
+			wv[5] = wv[4];
+			wv[4] = wv[3] + t1;
+			wv[3] = wv[2];
+			wv[2] = wv[1];
+			wv[1] = wv[0];
+			wv[0] = t1 + t2;
+		}
+		for (int j = 0; j < 8; j++) {
+			state[j] += wv[j];
+		}
+	}
+}
+
+#ifdef SHA256_SHANI
+static bool HasShaExtensions()
+{
+	// SHA (leaf 7 ebx bit 29) with SSSE3 and SSE4.1 (leaf 1 ecx bits 9 and 19) for the shuffles
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuidex(info, 7, 0);
+	u32 ebx7 = info[1];
+	__cpuid(info, 1);
+	u32 ecx1 = info[2];
+#else
+	if (__get_cpuid_max(0, NULL) < 7)
+		return false;
+	u32 eax, ebx, ecx, edx, ebx7, ecx1;
+	__cpuid_count(7, 0, eax, ebx7, ecx, edx);
+	__cpuid(1, eax, ebx, ecx1, edx);
+#endif
+	return (ebx7 & (1 << 29)) && (ecx1 & (1 << 9)) && (ecx1 & (1 << 19));
+}
+
+static const bool s_shani = HasShaExtensions();
+
+// four rounds with the schedule words in w, the old ABEF is CDGH after the first two
+#define SHA256_ROUNDS4(j, w) \
+	wk = _mm_add_epi32(w, _mm_loadu_si128((const __m128i*)&sha256_k[(j) * 4])); \
+	state1 = _mm_sha256rnds2_epu32(state1, state0, wk); \
+	state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E))
+
+// replaces the oldest four words of the schedule w0 by the next ones, w1 to w3 follow w0
+#define SHA256_SCHEDULE(w0, w1, w2, w3) \
+	w0 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4)), w3)
+
+// the state is kept as ABEF and CDGH, that is what sha256rnds2 works on
+#ifdef __GNUC__
+__attribute__((target("sha,ssse3,sse4.1")))
+#endif
+static void TransformShaNi(u32 state[8], const u8* message, size_t block_nb)
+{
+	const __m128i swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1); // CDAB
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B); // EFGH
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+	for (size_t i = 0; i < block_nb; i++) {
+		const __m128i* sub_block = (const __m128i*)(message + (i << 6));
+		__m128i abef = state0;
+		__m128i cdgh = state1;
+		__m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(sub_block), swap);
+		__m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(sub_block + 1), swap);
+		__m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128(sub_block + 2), swap);
+		__m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128(sub_block + 3), swap);
+		__m128i wk;
+
+		SHA256_ROUNDS4(0, w0);
+		SHA256_ROUNDS4(1, w1);
+		SHA256_ROUNDS4(2, w2);
+		SHA256_ROUNDS4(3, w3);
+		for (int j = 4; j < 16; j += 4) {
+			SHA256_SCHEDULE(w0, w1, w2, w3);
+			SHA256_ROUNDS4(j, w0);
+			SHA256_SCHEDULE(w1, w2, w3, w0);
+			SHA256_ROUNDS4(j + 1, w1);
+			SHA256_SCHEDULE(w2, w3, w0, w1);
+			SHA256_ROUNDS4(j + 2, w2);
+			SHA256_SCHEDULE(w3, w0, w1, w2);
+			SHA256_ROUNDS4(j + 3, w3);
+		}
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+	_mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, state1, 0xF0)); // DCBA
+	_mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(state1, tmp, 8)); // HGFE
+}
+#endif
+
+namespace Common {
+	void Sha256Transform(u32 state[8], const u8* blocks, size_t count)
+	{
+#ifdef SHA256_SHANI
+		if (s_shani) {
+			TransformShaNi(state, blocks, count);
+			return;
+		}
+#endif
+		TransformGeneric(state, blocks, count);
+	}
+
+	Sha256::Sha256() : m_used(0), m_total(0)
+	{
+		static const u32 init[8] = {
+			0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+			0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+		memcpy(m_state, init, sizeof(m_state));
+	}
+
+	void Sha256::Update(const void* data, size_t size)
+	{
+		const u8* p = (const u8*)data;
+		m_total += size;
+		if (m_used) {
+			size_t part = 64 - m_used < size ? 64 - m_used : size;
+			memcpy(m_block + m_used, p, part);
+			m_used += part;
+			p += part;
+			size -= part;
+			if (m_used < 64)
+				return;
+			Sha256Transform(m_state, m_block, 1);
+			m_used = 0;
+		}
+		// whole blocks are hashed right from the caller's buffer
+		Sha256Transform(m_state, p, size / 64);
+		p += size & ~63;
+		m_used = size & 63;
+		memcpy(m_block, p, m_used);
+	}
+
+	void Sha256::Final(u8 hash_out[0x20])
+	{
+		u64 bits = m_total << 3;
+		m_block[m_used++] = 0x80;
+		if (m_used > 56) {
+			memset(m_block + m_used, 0, 64 - m_used);
+			Sha256Transform(m_state, m_block, 1);
+			m_used = 0;
+		}
+		memset(m_block + m_used, 0, 56 - m_used);
+		for (int i = 0; i < 8; i++)
+			m_block[56 + i] = (u8)(bits >> (56 - i * 8));
+		Sha256Transform(m_state, m_block, 1);
+		for (int i = 0; i < 8; i++) {
+			hash_out[i * 4] = (u8)(m_state[i] >> 24);
+			hash_out[i * 4 + 1] = (u8)(m_state[i] >> 16);
+			hash_out[i * 4 + 2] = (u8)(m_state[i] >> 8);
+			hash_out[i * 4 + 3] = (u8)m_state[i];
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#include "Kernel.h"
+#include "Hardware.h"
+
+// the tests link this instead of the citra GPU in source/citraimport/GPU, the registers read 0
+namespace GPU {
+    template <typename T>
+    void Read(T &var, const u32 addr)
+    {
+        var = 0;
+    }
+
+    template <typename T>
+    void Write(u32 addr, const T data)
+    {
+    }
+
+    template void Read<u32>(u32 &var, const u32 addr);
+    template void Read<u16>(u16 &var, const u32 addr);
+    template void Read<u8>(u8 &var, const u32 addr);
+
+    template void Write<u32>(u32 addr, const u32 data);
+    template void Write<u16>(u32 addr, const u16 data);
+    template void Write<u8>(u32 addr, const u8 data);
+} // namespace
+
+extern "C" void VBlankCallback()
+{
+}
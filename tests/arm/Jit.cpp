@@ -0,0 +1,264 @@
+#include "Kernel.h"
+#include "Test.h"
+#include "arm/dyncom/arm_dyncom_interpreter.h"
+
+#include <random>
+
+KKernel* mykernel;
+bool novideo = true;
+bool dyncomjit = true;
+bool dyncomstats = false;
+extern "C" int citraPressedkey = 0;
+extern "C" bool citraSettingSkipGSP = true;
+extern "C" void citraFireInterrupt(int id) {}
+
+#ifdef ARCHITECTURE_x86_64
+
+#define CODE_ADDR 0x08100000
+#define DATA_ADDR 0x08000000
+#define DATA_SIZE 0x1000
+#define STACK_ADDR (DATA_ADDR + DATA_SIZE / 2)
+
+static const u32 s_flags[] = {
+    0xe0910002, // adds r0, r1, r2
+    0xe0513002, // subs r3, r1, r2
+    0xe0724001, // rsbs r4, r2, r1
+    0xe0b15002, // adcs r5, r1, r2
+    0xe0d26001, // sbcs r6, r2, r1
+    0xe0f17002, // rscs r7, r1, r2
+    0xe0118002, // ands r8, r1, r2
+    0xe1919002, // orrs r9, r1, r2
+    0xe031a002, // eors r10, r1, r2
+    0xe1d1b002, // bics r11, r1, r2
+    0xe1510002, // cmp r1, r2
+    0xe1710003, // cmn r1, r3
+    0xe1110002, // tst r1, r2
+    0xe1310003, // teq r1, r3
+    0xe1b0c000, // movs r12, r0
+    0xe1f00002, // mvns r0, r2
+    0xe0130291, // muls r3, r1, r2
+    0xe0345291, // mlas r4, r1, r2, r5
+};
+
+static const u32 s_conditions[] = {
+    0x02822001, // addeq r2, r2, #1
+    0x12833001, // addne r3, r3, #1
+    0x83a04001, // movhi r4, #1
+    0x93a05002, // movls r5, #2
+    0xa3a06003, // movge r6, #3
+    0xb3a07004, // movlt r7, #4
+    0xe1500001, // cmp r0, r1
+    0xc1a08000, // movgt r8, r0
+    0xd1a09001, // movle r9, r1
+    0x23a0a005, // movcs r10, #5
+    0x33a0b006, // movcc r11, #6
+    0x424cc001, // submi r12, r12, #1
+    0x528cc002, // addpl r12, r12, #2
+    0x60200001, // eorvs r0, r0, r1
+    0x70211000, // eorvc r1, r1, r0
+    0xe1720003, // cmn r2, r3
+    0x00944005, // addseq r4, r4, r5
+    0x10555006, // subsne r5, r5, r6
+};
+
+static const u32 s_shifter[] = {
+    0xe1b00081, // movs r0, r1, lsl #1
+    0xe1b021a1, // movs r2, r1, lsr #3
+    0xe1b03fc1, // movs r3, r1, asr #31
+    0xe1b043e1, // movs r4, r1, ror #7
+    0xe0115202, // ands r5, r1, r2, lsl #4
+    0xe3b06102, // movs r6, #0x80000000
+    0xe39174ff, // orrs r7, r1, #0xff000000
+    0xe3110001, // tst r1, #1
+    0xe03280c1, // eors r8, r2, r1, asr #1
+    0xe0919102, // adds r9, r1, r2, lsl #2
+    0xe1b0a001, // movs r10, r1
+    0xe1b0bfa1, // movs r11, r1, lsr #31
+    0xe1d2c861, // bics r12, r2, r1, ror #16
+    0xe1b00211, // movs r0, r1, lsl r2, the interpreter takes over here
+    0xe3b000ff, // movs r0, #255
+};
+
+static const u32 s_multiple[] = {
+    0xe92d403f, // stmdb sp!, {r0-r5, lr}
+    0xe8bd1fc0, // ldmia sp!, {r6-r12}
+    0xe88d0015, // stmia sp, {r0, r2, r4}
+    0xe91d000a, // ldmdb sp, {r1, r3}
+    0xe9ad000f, // stmib sp!, {r0-r3}
+    0xe83d00f0, // ldmda sp!, {r4-r7}
+    0xe80d0300, // stmda sp, {r8, r9}
+    0xe99d0c00, // ldmib sp, {r10, r11}
+    0xe52d0004, // str r0, [sp, #-4]!
+    0xe49d1004, // ldr r1, [sp], #4
+    0xe5cd2003, // strb r2, [sp, #3]
+    0xe5dd3003, // ldrb r3, [sp, #3]
+    0xe1cd40b6, // strh r4, [sp, #6]
+    0xe1dd50f6, // ldrsh r5, [sp, #6]
+    0xe1dd60d3, // ldrsb r6, [sp, #3]
+    0xe90d1fff, // stmdb sp, {r0-r12}
+    0xe89d1fff, // ldmia sp, {r0-r12}
+};
+
+// what a run leaves behind, it has to be the same with and without the JIT
+struct ArmState {
+    u32 reg[16];
+    u32 flags[5];
+    u32 executed;
+    u8 data[DATA_SIZE];
+
+    bool operator==(const ArmState& other) const {
+        return !memcmp(reg, other.reg, sizeof(reg)) && !memcmp(flags, other.flags, sizeof(flags)) &&
+            executed == other.executed && !memcmp(data, other.data, sizeof(data));
+    }
+};
+
+static std::mt19937 rng(0x11);
+
+static u32 RandomValue()
+{
+    static const u32 edges[] = { 0, 1, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, 0x80000001 };
+    if (rng() % 4 == 0)
+        return edges[rng() % (sizeof(edges) / sizeof(edges[0]))];
+    return rng();
+}
+
+class JitTest {
+public:
+    JitTest()
+    {
+        u8* code = (u8*)calloc(1, 0x1000);
+        u8* ro = (u8*)calloc(1, 0x1000);
+        u8* data = (u8*)calloc(1, 0x1000);
+        char name[8] = "jit";
+        KCodeSet* codeset = new KCodeSet(code, 1, ro, 1, data, 1, 0, 0, name);
+        m_process = new KProcess(codeset, 0, NULL, mykernel, true);
+        u32 unused;
+        m_process->getMemoryMap()->ControlMemory(&unused, DATA_ADDR, 0, DATA_SIZE, OPERATION_COMMIT, PERMISSION_RW);
+        m_process->getMemoryMap()->ControlMemory(&unused, CODE_ADDR, 0, 0x1000, OPERATION_COMMIT, PERMISSION_RW);
+        m_thread = new KThread(0, m_process);
+        m_cpu = m_dyncom.state;
+        m_cpu->m_MemoryMap = m_process->getMemoryMap();
+        m_cpu->m_currentThread = m_thread;
+    }
+
+    /// Loads the snippet, it is followed by an endless loop
+    void Load(const u32* code, u32 count)
+    {
+        KMemoryMap* memory = m_process->getMemoryMap();
+        for (u32 i = 0; i < count; i++)
+            memory->Write32(CODE_ADDR + i * 4, code[i]);
+        memory->Write32(CODE_ADDR + count * 4, 0xEAFFFFFE);
+        m_count = count;
+    }
+
+    /// Runs the snippet from the same registers, flags and memory and returns where it got
+    ArmState Run(const u32* regs, const u32* flags, const u8* data, bool jit)
+    {
+        KMemoryMap* memory = m_process->getMemoryMap();
+        for (u32 i = 0; i < DATA_SIZE; i++)
+            memory->Write8(DATA_ADDR + i, data[i]);
+        m_process->CreamCache->Clear();
+        m_process->m_jit->Clear();
+
+        memcpy(m_cpu->Reg, regs, sizeof(m_cpu->Reg));
+        m_cpu->Reg[15] = CODE_ADDR;
+        m_cpu->NFlag = flags[0];
+        m_cpu->ZFlag = flags[1];
+        m_cpu->CFlag = flags[2];
+        m_cpu->VFlag = flags[3];
+        m_cpu->TFlag = 0;
+        m_cpu->Cpsr = 0x10;
+        m_cpu->NirqSig = HIGH;
+        m_cpu->inst_arena = m_process->CreamBuffer;
+        m_cpu->CreamCache = m_process->CreamCache;
+        m_cpu->m_jit = jit ? m_process->m_jit : NULL;
+        m_cpu->NumInstrsToExecute = m_count + 4;
+
+        ArmState state;
+        state.executed = InterpreterMainLoop(m_cpu);
+        memcpy(state.reg, m_cpu->Reg, sizeof(state.reg));
+        state.flags[0] = m_cpu->NFlag;
+        state.flags[1] = m_cpu->ZFlag;
+        state.flags[2] = m_cpu->CFlag;
+        state.flags[3] = m_cpu->VFlag;
+        state.flags[4] = m_cpu->TFlag;
+        for (u32 i = 0; i < DATA_SIZE; i++)
+            memory->Read8(DATA_ADDR + i, state.data[i]);
+        return state;
+    }
+
+    /// Runs the snippet from random states with and without the JIT, returns the number of runs that differ
+    u32 Compare(const u32* code, u32 count, u32 runs)
+    {
+        Load(code, count);
+        u32 bad = 0;
+        static u8 data[DATA_SIZE];
+        for (u32 run = 0; run < runs; run++) {
+            u32 regs[16];
+            u32 flags[4];
+            for (int i = 0; i < 16; i++)
+                regs[i] = RandomValue();
+            // the shift by register reads the low byte, keep it in range now and then
+            if (run & 1)
+                regs[2] &= 0x3F;
+            regs[13] = STACK_ADDR;
+            for (int i = 0; i < 4; i++)
+                flags[i] = rng() & 1;
+            for (u32 i = 0; i < DATA_SIZE; i++)
+                data[i] = rng();
+
+            ArmState interpreted = Run(regs, flags, data, false);
+            ArmState compiled = Run(regs, flags, data, true);
+            if (!(interpreted == compiled))
+                bad++;
+        }
+        return bad;
+    }
+
+    /// True if the JIT compiled the start of the loaded snippet
+    bool Compiled()
+    {
+        return m_process->m_jit->GetBlock(m_cpu, CODE_ADDR, m_count + 1) != nullptr;
+    }
+
+private:
+    KProcess* m_process;
+    KThread* m_thread;
+    ARM_DynCom m_dyncom;
+    ARMul_State* m_cpu;
+    u32 m_count;
+};
+
+#define SNIPPET(code) code, sizeof(code) / sizeof(code[0])
+
+int main(int argc, char* argv[])
+{
+    TEST_START("Jit");
+
+    mykernel = new KKernel();
+    Mem_Init(false);
+    Mem_SharedMemInit();
+    JitTest test;
+
+    EXPECT(test.Compare(SNIPPET(s_flags), 300) == 0, "data processing with S");
+    EXPECT(test.Compiled(), "data processing is compiled");
+    EXPECT(test.Compare(SNIPPET(s_conditions), 300) == 0, "conditional execution");
+    EXPECT(test.Compiled(), "conditional execution is compiled");
+    EXPECT(test.Compare(SNIPPET(s_shifter), 300) == 0, "shifter carry");
+    EXPECT(test.Compiled(), "shifter operands are compiled");
+    EXPECT(test.Compare(SNIPPET(s_multiple), 300) == 0, "LDM/STM");
+    EXPECT(test.Compiled(), "LDM/STM is compiled");
+
+    TEST_END();
+}
+
+#else
+
+int main(int argc, char* argv[])
+{
+    TEST_START("Jit");
+    printf("there is no JIT for this host\n");
+    TEST_END();
+}
+
+#endif // ARCHITECTURE_x86_64
@@ -0,0 +1,288 @@
+#include "Kernel.h"
+#include "Bootloader.h"
+#include "Test.h"
+
+#include <random>
+#include <vector>
+
+KKernel* mykernel;
+bool novideo = true;
+bool dyncomjit = false;
+bool dyncomstats = false;
+extern "C" int citraPressedkey = 0;
+extern "C" bool citraSettingSkipGSP = true;
+extern "C" void citraFireInterrupt(int id) {}
+
+static std::mt19937 rng(0x3d5);
+
+static u32 Random(u32 n)
+{
+    return rng() % n;
+}
+
+// the loader before the copies were batched, every byte goes on its own
+static int ReferenceDecompress(u8* compressed, u32 compressedsize, u8* decompressed, u32 decompressedsize)
+{
+    u8* footer = compressed + compressedsize - 8;
+    u32 buffertopandbottom = footer[0] | footer[1] << 8 | footer[2] << 16 | footer[3] << 24;
+    u32 i, j;
+    u32 out = decompressedsize;
+    u32 index = compressedsize - ((buffertopandbottom >> 24) & 0xFF);
+    u32 segmentoffset;
+    u32 segmentsize;
+    u8 control;
+    u32 stopindex = compressedsize - (buffertopandbottom & 0xFFFFFF);
+
+    memset(decompressed, 0, decompressedsize);
+    memcpy(decompressed, compressed, compressedsize);
+
+    while (index > stopindex) {
+        control = compressed[--index];
+
+        for (i = 0; i<8; i++) {
+            if (index <= stopindex)
+                break;
+            if (index <= 0)
+                break;
+            if (out <= 0)
+                break;
+
+            if (control & 0x80) {
+                if (index < 2)
+                    return 0;
+
+                index -= 2;
+
+                segmentoffset = compressed[index] | (compressed[index + 1] << 8);
+                segmentsize = ((segmentoffset >> 12) & 15) + 3;
+                segmentoffset &= 0x0FFF;
+                segmentoffset += 2;
+
+                if (out < segmentsize)
+                    return 0;
+
+                for (j = 0; j<segmentsize; j++) {
+                    u8 data;
+
+                    if (out + segmentoffset >= decompressedsize)
+                        return 0;
+
+                    data = decompressed[out + segmentoffset];
+                    decompressed[--out] = data;
+                }
+            }
+            else {
+                if (out < 1)
+                    return 0;
+                decompressed[--out] = compressed[--index];
+            }
+            control <<= 1;
+        }
+    }
+
+    return 1;
+}
+
+// one literal (size 0) or back-reference in the order the decompressor reads them, from the top down
+struct Token {
+    u32 size;
+    u32 offset; // as stored, the copy starts offset + 3 bytes above the output
+};
+
+static void Write32(u8* p, u32 value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+/**
+ * Builds a compressed .code with plain bytes at the bottom that are left alone
+ * @param tokens Contents of the compressed part, from the top down
+ * @param plain Number of bytes below the compressed part
+ * @param extra Bytes the data grows by, it ends right at the bottom of the output if this matches the tokens
+ */
+static std::vector<u8> Build(const std::vector<Token>& tokens, u32 plain, u32 extra)
+{
+    std::vector<u8> body;
+    for (size_t i = 0; i < tokens.size(); i += 8) {
+        u8 control = 0;
+        std::vector<u8> group;
+        for (size_t j = i; j < i + 8 && j < tokens.size(); j++) {
+            if (tokens[j].size) {
+                u32 value = ((tokens[j].size - 3) << 12) | tokens[j].offset;
+                control |= 0x80 >> (j - i);
+                group.push_back(value >> 8);
+                group.push_back(value & 0xFF);
+            } else {
+                group.push_back(Random(0x100));
+            }
+        }
+        body.push_back(control);
+        body.insert(body.end(), group.begin(), group.end());
+    }
+
+    std::vector<u8> compressed(plain + body.size() + 8);
+    for (u32 i = 0; i < plain; i++)
+        compressed[i] = Random(0x100);
+    // the body is read backwards
+    for (size_t i = 0; i < body.size(); i++)
+        compressed[plain + body.size() - 1 - i] = body[i];
+    Write32(&compressed[plain + body.size()], (8 << 24) | (u32)(body.size() + 8));
+    Write32(&compressed[plain + body.size() + 4], extra);
+    return compressed;
+}
+
+/// Bytes the tokens write, the output is that much above the plain bytes
+static u32 OutputSize(const std::vector<Token>& tokens)
+{
+    u32 size = 0;
+    for (size_t i = 0; i < tokens.size(); i++)
+        size += tokens[i].size ? tokens[i].size : 1;
+    return size;
+}
+
+/// Returns false if the two decompressors disagree, the output only counts if the data was good
+static bool Same(std::vector<u8>& compressed, bool* ok_out = NULL)
+{
+    u32 size = GetDecompressedSize(&compressed[0], compressed.size());
+    std::vector<u8> expected(size), actual(size);
+    int expected_ok = ReferenceDecompress(&compressed[0], compressed.size(), &expected[0], size);
+    int actual_ok = Decompress(&compressed[0], compressed.size(), &actual[0], size);
+    if (ok_out)
+        *ok_out = expected_ok != 0;
+    return expected_ok == actual_ok && (!expected_ok || expected == actual);
+}
+
+/// Builds a stream that ends right at the bottom of the output, the tokens are padded with long copies if they shrink
+static std::vector<u8> BuildExact(std::vector<Token> tokens, u32 plain)
+{
+    u32 body = 0;
+    for (size_t i = 0; i < tokens.size(); i++)
+        body += tokens[i].size ? 2 : 1;
+    body += (tokens.size() + 7) / 8;
+    while (OutputSize(tokens) < body + 8) {
+        Token token = { 18, 0 };
+        tokens.push_back(token);
+        body += 2 + (tokens.size() % 8 == 1);
+    }
+    return Build(tokens, plain, OutputSize(tokens) - body - 8);
+}
+
+/// Random literals and copies, every copy reads from what was written already, the first three are literals
+static std::vector<Token> RandomTokens(u32 count, u32 literal_percent, u32 max_offset)
+{
+    std::vector<Token> tokens;
+    u32 written = 0;
+    for (u32 i = 0; i < count; i++) {
+        Token token = { 0, 0 };
+        if (written >= 3 && Random(100) >= literal_percent) {
+            u32 limit = written - 3 < max_offset ? written - 3 : max_offset;
+            token.size = 3 + Random(16);
+            token.offset = Random(limit + 1);
+        }
+        written += token.size ? token.size : 1;
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+int main(int argc, char* argv[])
+{
+    TEST_START("Decompress");
+
+    u32 bad = 0;
+    u32 invalid = 0;
+    for (int i = 0; i < 2000; i++) {
+        std::vector<Token> tokens = RandomTokens(3 + Random(0x2000), Random(100), 0xFFF);
+        std::vector<u8> compressed = BuildExact(tokens, Random(2) ? 0 : Random(0x100));
+        bool ok;
+        if (!Same(compressed, &ok))
+            bad++;
+        if (!ok)
+            invalid++;
+    }
+    EXPECT(bad == 0, "random streams");
+    EXPECT(invalid == 0, "random streams are valid");
+
+    // displacement below the length, the copy reads bytes it wrote itself
+    bad = 0;
+    for (u32 offset = 0; offset < 16; offset++) {
+        for (u32 size = 3; size <= 18; size++) {
+            std::vector<Token> tokens;
+            for (int i = 0; i < 20; i++) {
+                Token literal = { 0, 0 };
+                tokens.push_back(literal);
+            }
+            for (int i = 0; i < 40; i++) {
+                Token copy = { size, offset };
+                tokens.push_back(copy);
+            }
+            std::vector<u8> compressed = BuildExact(tokens, 0);
+            bool ok;
+            if (!Same(compressed, &ok) || !ok)
+                bad++;
+        }
+    }
+    EXPECT(bad == 0, "overlapping copies");
+
+    bad = 0;
+    for (int i = 0; i < 500; i++) {
+        std::vector<Token> tokens = RandomTokens(3 + Random(0x400), Random(50), 15);
+        std::vector<u8> compressed = BuildExact(tokens, 0);
+        if (!Same(compressed))
+            bad++;
+    }
+    EXPECT(bad == 0, "short displacements");
+
+    // copies from the very top of what was written and one byte past it
+    bad = 0;
+    for (u32 written = 3; written < 40; written++) {
+        for (int past = 0; past < 2; past++) {
+            std::vector<Token> tokens;
+            for (u32 i = 0; i < written; i++) {
+                Token literal = { 0, 0 };
+                tokens.push_back(literal);
+            }
+            Token copy = { 3 + Random(16), written - 3 + past };
+            tokens.push_back(copy);
+            std::vector<u8> compressed = BuildExact(tokens, Random(0x10));
+            bool ok;
+            if (!Same(compressed, &ok) || ok == (past != 0))
+                bad++;
+        }
+    }
+    EXPECT(bad == 0, "copies at the top of the output");
+
+    // the output runs into the bottom of the buffer, in the middle of a control byte and at its end
+    bad = 0;
+    for (u32 count = 1; count < 64; count++) {
+        for (u32 short_by = 0; short_by < 3; short_by++) {
+            std::vector<Token> tokens = RandomTokens(count, 30, 0xFFF);
+            std::vector<u8> good = BuildExact(tokens, 0);
+            u32 extra = good[good.size() - 4] | good[good.size() - 3] << 8 | good[good.size() - 2] << 16 | good[good.size() - 1] << 24;
+            if (extra < short_by)
+                continue;
+            Write32(&good[good.size() - 4], extra - short_by);
+            if (!Same(good))
+                bad++;
+        }
+    }
+    EXPECT(bad == 0, "output ending at the start of the buffer");
+
+    // only has to fail the same way
+    bad = 0;
+    for (int i = 0; i < 2000; i++) {
+        std::vector<u8> compressed(0x20 + Random(0x400));
+        for (size_t j = 0; j < compressed.size(); j++)
+            compressed[j] = Random(0x100);
+        Write32(&compressed[compressed.size() - 8], (8 << 24) | (8 + Random((u32)compressed.size() - 8)));
+        Write32(&compressed[compressed.size() - 4], Random(0x1000));
+        if (!Same(compressed))
+            bad++;
+    }
+    EXPECT(bad == 0, "random data");
+
+    TEST_END();
+}